@@ -0,0 +1,136 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include "simulator.h"
+#include "asm_cache.h"
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+// Function to fold a buffer into a running FNV-1a hash
+unsigned long long fnv1a(unsigned long long hash, const void* buffer, size_t length){
+    const unsigned char* bytes = buffer;
+    for(size_t i = 0; i < length; i++){
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Function to hash the source file along with everything that affects its encoding
+unsigned long long hash_source(FILE* fptr){
+    /*
+    The assembler version and table sizes are mixed in so that a change to the encoder
+    or to the layout of the line table never reuses a stale image
+    */
+    unsigned long long hash = FNV_OFFSET;
+    int layout[3] = {MAX_INSTRS, MAX_LINE_LEN, MAX_LABEL_LEN};
+    hash = fnv1a(hash, ASSEMBLER_VERSION, strlen(ASSEMBLER_VERSION));
+    hash = fnv1a(hash, layout, sizeof(layout));
+
+    char buffer[4096];
+    size_t length;
+    rewind(fptr);
+    while((length = fread(buffer, 1, sizeof(buffer), fptr)) > 0){
+        hash = fnv1a(hash, buffer, length);
+    }
+    rewind(fptr);
+    return hash;
+}
+
+// Function to build the path of the cache file for a given hash
+void asm_cache_path(unsigned long long hash, char* path, size_t size){
+    snprintf(path, size, "%s/%016llx.bin", ASM_CACHE_DIR, hash);
+}
+
+// Maps a cached image and copies it into the text section, data section, labels and line table
+int asm_cache_load(unsigned long long hash){
+    char path[64];
+    asm_cache_path(hash, path, sizeof(path));
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return 0;    // Nothing cached for this source yet
+
+    struct stat st;
+    if(fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(asm_cache_header)){
+        close(fd);
+        return 0;
+    }
+    char* image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED) return 0;
+
+    asm_cache_header* header = (asm_cache_header*)image;
+    size_t expected = sizeof(asm_cache_header) + header->instr_count * sizeof(unsigned) + header->data_size
+                    + (header->label_count + header->data_label_count) * sizeof(label_info) + header->line_count * (sizeof(int) + MAX_LINE_LEN);
+    // Rejecting images that are corrupt, truncated or do not fit the current tables
+    if(header->magic != ASM_CACHE_MAGIC || header->hash != hash || expected != (size_t)st.st_size ||
+       header->instr_count < 0 || header->instr_count > DATA_START / 4 ||
+       header->data_size < 0 || header->data_size > STACK_START - DATA_START ||
+       header->label_count < 0 || header->label_count > MAX_LABELS ||
+       header->data_label_count < 0 || header->data_label_count > MAX_LABELS ||
+       header->line_count < 0 || header->line_count > MAX_INSTRS){
+        munmap(image, st.st_size);
+        return 0;
+    }
+
+    char* cursor = image + sizeof(asm_cache_header);
+    memcpy(text_section, cursor, header->instr_count * sizeof(unsigned));
+    cursor += header->instr_count * sizeof(unsigned);
+
+    for(int i = 0; i < header->data_size; i++){
+        data_section[i] = (unsigned char)cursor[i];     // Memory holds one byte per element
+    }
+    cursor += header->data_size;
+
+    memcpy(labels, cursor, header->label_count * sizeof(label_info));
+    cursor += header->label_count * sizeof(label_info);
+    memcpy(data_labels, cursor, header->data_label_count * sizeof(label_info));
+    cursor += header->data_label_count * sizeof(label_info);
+
+    memcpy(instruction_lines, cursor, header->line_count * sizeof(int));
+    cursor += header->line_count * sizeof(int);
+
+    memcpy(instructions, cursor, header->line_count * MAX_LINE_LEN);
+
+    instr_count = header->instr_count;
+    label_count = header->label_count;
+    data_label_count = header->data_label_count;
+    data_end = DATA_START + header->data_size;
+    munmap(image, st.st_size);
+    return 1;
+}
+
+// Writes the state produced by a successful assembly to the cache
+void asm_cache_store(unsigned long long hash, int data_size, int line_count){
+    /*
+    The image is written to a temporary file and renamed into place, so a concurrent
+    reload from another script never maps a half written file
+    */
+    if(mkdir(ASM_CACHE_DIR, 0755) < 0 && access(ASM_CACHE_DIR, W_OK) < 0) return;
+
+    char path[64], temp_path[80];
+    asm_cache_path(hash, path, sizeof(path));
+    snprintf(temp_path, sizeof(temp_path), "%s.%d", path, (int)getpid());
+
+    FILE* fptr = fopen(temp_path, "wb");
+    if(!fptr) return;
+
+    asm_cache_header header = {ASM_CACHE_MAGIC, hash, instr_count, data_size, label_count, data_label_count, line_count};
+    int error = fwrite(&header, sizeof(header), 1, fptr) != 1;
+    error |= fwrite(text_section, sizeof(unsigned), instr_count, fptr) != (size_t)instr_count;
+
+    for(int i = 0; i < data_size && !error; i++){
+        error = fputc(data_section[i] & 0xff, fptr) == EOF;
+    }
+    error |= fwrite(labels, sizeof(label_info), label_count, fptr) != (size_t)label_count;
+    error |= fwrite(data_labels, sizeof(label_info), data_label_count, fptr) != (size_t)data_label_count;
+    error |= fwrite(instruction_lines, sizeof(int), line_count, fptr) != (size_t)line_count;
+    error |= fwrite(instructions, MAX_LINE_LEN, line_count, fptr) != (size_t)line_count;
+
+    if(fclose(fptr) != 0 || error || rename(temp_path, path) < 0) remove(temp_path);
+}
\ No newline at end of file
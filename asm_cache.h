@@ -0,0 +1,23 @@
+#include <stdio.h>
+
+#ifndef ASM_CACHE_H
+#define ASM_CACHE_H
+
+#define ASM_CACHE_DIR ".asm_cache"
+#define ASM_CACHE_MAGIC 0x43415652  // "RVAC"
+
+typedef struct{
+    unsigned magic;
+    unsigned long long hash;    // Hash of the source text and assembler version
+    int instr_count;            // Words in the encoded text image
+    int data_size;              // Bytes in the initialized data image
+    int label_count;
+    int data_label_count;
+    int line_count;             // Entries in the line table
+} asm_cache_header;
+
+unsigned long long hash_source(FILE* fptr);
+int asm_cache_load(unsigned long long hash);
+void asm_cache_store(unsigned long long hash, int data_size, int line_count);
+
+#endif
\ No newline at end of file
@@ -7,8 +7,11 @@
 
 int line_num = 0;
 
-label_info labels[MAX_LINES];
+label_info labels[MAX_LABELS];
 int label_count = 0; // Count of labels
+label_info data_labels[MAX_LABELS];
+int data_label_count = 0;
+unsigned data_end = DATA_START;
 
 typedef struct{
     char alias[5];  // Register alias (e.g., zero, ra)
@@ -26,24 +29,46 @@ reg_alias reg_aliases[] = {
 };
 
 typedef struct{
-    char name[4];      // Instruction name (e.g., add, sub)
+    char name[7];      // Instruction name (e.g., add, sub)
     char funct3[4];    // funct3 field (3 bits)
     char funct7[8];    // funct7 field (7 bits)
+    char opcode[8];    // OP, or OP-32 for the word forms
 } r_format;
 
 r_format r_instructions[] = {   // Struct array for R format instructions
-    {"add", "000", "0000000"},
-    {"sub", "000", "0100000"},
-    {"and", "111", "0000000"},
-    {"or",  "110", "0000000"},
-    {"xor", "100", "0000000"},
-    {"sll", "001", "0000000"},
-    {"srl", "101", "0000000"},
-    {"sra", "101", "0100000"}
+    {"add", "000", "0000000", "0110011"},
+    {"sub", "000", "0100000", "0110011"},
+    {"and", "111", "0000000", "0110011"},
+    {"or",  "110", "0000000", "0110011"},
+    {"xor", "100", "0000000", "0110011"},
+    {"sll", "001", "0000000", "0110011"},
+    {"srl", "101", "0000000", "0110011"},
+    {"sra", "101", "0100000", "0110011"},
+    {"slt", "010", "0000000", "0110011"},
+    {"sltu", "011", "0000000", "0110011"},
+    {"addw", "000", "0000000", "0111011"},
+    {"subw", "000", "0100000", "0111011"},
+    {"sllw", "001", "0000000", "0111011"},
+    {"srlw", "101", "0000000", "0111011"},
+    {"sraw", "101", "0100000", "0111011"},
+    // RV64M
+    {"mul",    "000", "0000001", "0110011"},
+    {"mulh",   "001", "0000001", "0110011"},
+    {"mulhsu", "010", "0000001", "0110011"},
+    {"mulhu",  "011", "0000001", "0110011"},
+    {"div",    "100", "0000001", "0110011"},
+    {"divu",   "101", "0000001", "0110011"},
+    {"rem",    "110", "0000001", "0110011"},
+    {"remu",   "111", "0000001", "0110011"},
+    {"mulw",   "000", "0000001", "0111011"},
+    {"divw",   "100", "0000001", "0111011"},
+    {"divuw",  "101", "0000001", "0111011"},
+    {"remw",   "110", "0000001", "0111011"},
+    {"remuw",  "111", "0000001", "0111011"}
 };
 // Similarly, struct arrays for all formats of instructions
 typedef struct{
-    char name[5];
+    char name[6];
     char funct3[4];
     char opcode[8];
 } i_format;
@@ -56,6 +81,12 @@ i_format i_instructions[] = {
     {"slli", "001", "0010011"},
     {"srli", "101", "0010011"},
     {"xori", "100", "0010011"},
+    {"slti", "010", "0010011"},
+    {"sltiu", "011", "0010011"},
+    {"addiw", "000", "0011011"},
+    {"slliw", "001", "0011011"},
+    {"srliw", "101", "0011011"},
+    {"sraiw", "101", "0011011"}
 };
 
 i_format i_part_2[] = {
@@ -106,12 +137,38 @@ j_format j_instructions[] = {
 };
 
 typedef struct{
-    char name[4];
+    char name[6];
     char opcode[8];
 } u_format;
 
 u_format u_instructions[] = {
-    {"lui", "0110111"}
+    {"lui", "0110111"},
+    {"auipc", "0010111"}
+};
+
+typedef struct{
+    char name[7];
+    char funct3[4];
+} csr_format;
+
+csr_format csr_instructions[] = {
+    {"csrrw", "001"},
+    {"csrrs", "010"},
+    {"csrrc", "011"},
+    {"csrrwi", "101"},
+    {"csrrsi", "110"},
+    {"csrrci", "111"}
+};
+
+typedef struct{
+    char name[10];
+    char csr[8];        // Counter read by the pseudo-instruction
+} csr_pseudo;
+
+csr_pseudo csr_reads[] = {   // rdcycle rd is csrrs rd cycle x0, and so on
+    {"rdcycle", "cycle"},
+    {"rdtime", "time"},
+    {"rdinstret", "instret"}
 };
 // Function to convert registers to binary form
 int reg_to_bin(char* reg, char* bin){
@@ -174,8 +231,6 @@ void bin_to_hex(const char* bin, char* hex){
 
 // Function to handle R format instructions
 int r_cmds(char* inst_name, char* rd, char* rs1, char* rs2, FILE* optr, int line_num){
-    const char* r_opcode = "0110011";  // Common opcode for all R-format instructions
-
     for(int i = 0; i < sizeof(r_instructions) / sizeof(r_format); i++){
         if (strcmp(inst_name, r_instructions[i].name) == 0) {
             char rd_bin[6];
@@ -187,7 +242,7 @@ int r_cmds(char* inst_name, char* rd, char* rs1, char* rs2, FILE* optr, int line
 
             if(c1 && c2 && c3){
                 char machine_code_bin[33];
-                snprintf(machine_code_bin, sizeof(machine_code_bin), "%s%s%s%s%s%s", r_instructions[i].funct7, rs2_bin, rs1_bin, r_instructions[i].funct3, rd_bin, r_opcode);
+                snprintf(machine_code_bin, sizeof(machine_code_bin), "%s%s%s%s%s%s", r_instructions[i].funct7, rs2_bin, rs1_bin, r_instructions[i].funct3, rd_bin, r_instructions[i].opcode);
 
                 char machine_code_hex[9];
                 bin_to_hex(machine_code_bin, machine_code_hex);
@@ -210,6 +265,16 @@ int i_cmds_1(char* instr_name, char* rd, char* rs1, char* imm, FILE* optr, int l
             int c3 = reg_to_bin(rd, rd_bin);
             int c1 = reg_to_bin(rs1, rs1_bin);
             int imm_val = -1;
+            // Shift amounts go up to 63, and up to 31 for the word shifts
+            int is_shift = strcmp(instr_name, "slli") == 0 || strcmp(instr_name, "srli") == 0 || strcmp(instr_name, "srai") == 0;
+            int is_word_shift = strcmp(instr_name, "slliw") == 0 || strcmp(instr_name, "srliw") == 0 || strcmp(instr_name, "sraiw") == 0;
+            if(is_shift || is_word_shift){
+                int shamt = atoi(imm);
+                if(shamt < 0 || shamt > (is_shift ? 63 : 31)){
+                    fprintf(stderr, "Error at line %d\nShift amount needs to lie between 0 and %d", line_num, is_shift ? 63 : 31);
+                    return 0;
+                }
+            }
             // Convert immediate value to binary (12 bits)
             if(imm_val == -1){
                 imm_val = atoi(imm);
@@ -232,12 +297,12 @@ int i_cmds_1(char* instr_name, char* rd, char* rs1, char* imm, FILE* optr, int l
             if(c1 && c3){
                 const char* funct6 = "000000";
                 char machine_code_bin[33];
-                if(strcmp(instr_name, "srai") == 0){
+                if(strcmp(instr_name, "srai") == 0 || strcmp(instr_name, "sraiw") == 0){
                     funct6 = "010000";
                     snprintf(machine_code_bin, sizeof(machine_code_bin), "%s%s%s%s%s%s", 
                         funct6, imm_bin + 6, rs1_bin, i_instructions[i].funct3, rd_bin, i_instructions[i].opcode);
                 }
-                else if(strcmp(instr_name, "srli") == 0 || strcmp(instr_name, "slli") == 0){
+                else if(is_shift || is_word_shift){
                     snprintf(machine_code_bin, sizeof(machine_code_bin), "%s%s%s%s%s%s", 
                         funct6, imm_bin + 6, rs1_bin, i_instructions[i].funct3, rd_bin, i_instructions[i].opcode);
                 }
@@ -560,7 +625,7 @@ int j_cmds(char* inst_name, char* rd, char* offset_str, FILE* optr, int line_num
         char imm_19_12[9];
         strncpy(imm_19_12, offset_bin + 1, 8);
         imm_19_12[8] = '\0';
-        char imm_11 = offset_bin[8];
+        char imm_11 = offset_bin[9];
         char imm_10_1[11];
         strncpy(imm_10_1, offset_bin + 10, 10);
         imm_10_1[10] = '\0';
@@ -610,6 +675,79 @@ int u_cmds(char* rd, char* imm, char* opcode, FILE* optr, int line_num){
         return 0;
     }
 }
+// Function to convert a CSR name or number to its 12-bit address, returns -1 if unknown
+int csr_number(char* csr){
+    int counter;
+    char extra;
+    if(strcmp(csr, "cycle") == 0) return CSR_CYCLE;
+    if(strcmp(csr, "time") == 0) return CSR_TIME;
+    if(strcmp(csr, "instret") == 0) return CSR_INSTRET;
+    if(sscanf(csr, "hpmcounter%d%c", &counter, &extra) == 1 && counter >= 3 && counter <= 31) return CSR_HPMCOUNTER3 + counter - 3;
+    if(isdigit(csr[0])){
+        char* end;
+        long value = strtol(csr, &end, 0);
+        if(*end == '\0' && value >= 0 && value < 4096) return value;
+    }
+    return -1;
+}
+// Function to handle Zicsr instructions, source is rs1 or a 5-bit immediate for the i forms
+int csr_cmds(char* inst_name, char* rd, char* csr, char* source, FILE* optr, int line_num){
+    const char* csr_opcode = "1110011";
+    for(int i = 0; i < sizeof(csr_instructions) / sizeof(csr_format); i++){
+        if(strcmp(inst_name, csr_instructions[i].name) == 0){
+            char rd_bin[6];
+            char source_bin[6];
+            int c1 = reg_to_bin(rd, rd_bin);
+            int c2 = 1;
+            if(inst_name[strlen(inst_name) - 1] == 'i'){
+                int uimm = atoi(source);
+                if(!isdigit(source[0]) || uimm > 31){
+                    fprintf(stderr, "Error in line %d\nImmediate value needs to lie between 0 and 31\n", line_num);
+                    return 0;
+                }
+                for(int j = 4; j >= 0; j--){
+                    source_bin[j] = (uimm % 2) + '0';
+                    uimm /= 2;
+                }
+                source_bin[5] = '\0';
+            }
+            else c2 = reg_to_bin(source, source_bin);
+            if(!c1 || !c2){
+                fprintf(stderr, "Error in line %d\nUnknown register found\n", line_num);
+                return 0;
+            }
+
+            int csr_val = csr_number(csr);
+            if(csr_val < 0){
+                fprintf(stderr, "Error in line %d\nUnknown CSR: %s\n", line_num, csr);
+                return 0;
+            }
+            char csr_bin[13];
+            for(int j = 11; j >= 0; j--){
+                csr_bin[j] = (csr_val % 2) + '0';
+                csr_val /= 2;
+            }
+            csr_bin[12] = '\0';
+
+            char machine_code_bin[33];
+            snprintf(machine_code_bin, sizeof(machine_code_bin), "%s%s%s%s%s", csr_bin, source_bin, csr_instructions[i].funct3, rd_bin, csr_opcode);
+            char machine_code_hex[9];
+            bin_to_hex(machine_code_bin, machine_code_hex);
+            fprintf(optr, "%s\n", machine_code_hex);
+            return 1;
+        }
+    }
+    return 0;
+}
+// Function to follow .data and .text directives while scanning, returns 1 for lines of the data section
+int skip_data_line(const char* line, int* in_data){
+    char directive[8];
+    if(sscanf(line, "%7s", directive) == 1){
+        if(strcmp(directive, ".data") == 0) *in_data = 1;
+        else if(strcmp(directive, ".text") == 0) *in_data = 0;
+    }
+    return *in_data;
+}
 // Function to read the input file and identify labels and their positions
 int parse_labels(FILE* fptr){
     /*
@@ -619,8 +757,10 @@ int parse_labels(FILE* fptr){
     char line[MAX_LINE_LEN];
     int address = 0;
     int line_num = 0;
+    int in_data = 0;
     while(fgets(line, sizeof(line), fptr)){
         line_num++;
+        if(skip_data_line(line, &in_data)) continue;    // Data labels are read by the loader
         if(line[0] == '\n' || line[0] == ';' || line[0] == '.' || line[0] == '#') continue;   // Accounting for empty lines and comments
         char* label_end = strchr(line, ':');
         if(label_end){
@@ -654,7 +794,7 @@ int parse_labels(FILE* fptr){
     return 1;
 }
 // Function to read the input file again and encode instructions one by one
-void process_instructions(FILE* fptr, FILE* optr){
+int process_instructions(FILE* fptr, FILE* optr){
     /*
     If a line has excess tokens, they are ignored and the code tries to make use of the required number of tokens and generate machine code
     Example: add x0 x0 x0 74....the 74 is ignored, and the add x0 x0 x0 is encoded
@@ -664,9 +804,11 @@ void process_instructions(FILE* fptr, FILE* optr){
     int current_address = 0; // Track the current address while processing
     char line[MAX_LINE_LEN];
     int sen = 1;
+    int in_data = 0;
     while(fgets(line, sizeof(line), fptr) && sen){
         // Accounting for empty lines and comments
         line_num++; // Keeping track of line numbers for error handling
+        if(skip_data_line(line, &in_data)) continue;
         if(line[0] == '\n') continue;
         if(line[0] == ';' || line[0] == '#' || line[0] == '.') continue;
         // Checking for and removing the labels (if any)
@@ -691,11 +833,13 @@ void process_instructions(FILE* fptr, FILE* optr){
             char* rd = strtok(NULL, ", \t\n");
             if(rd == NULL){
                 fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+                sen = 0;
                 break;
             }
             char* linked_label = strtok(NULL, ", \t\n");
             if(linked_label == NULL){
                 fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+                sen = 0;
                 break;
             }
             char* dummy = strtok(NULL, ", \t\n");
@@ -723,6 +867,7 @@ void process_instructions(FILE* fptr, FILE* optr){
             // Handling missing labels
             if(!label_found){
                 fprintf(stderr, "Error in line %d: Label '%s' not found.\n", line_num, linked_label);
+                sen = 0;
                 break;
             }
 
@@ -730,7 +875,40 @@ void process_instructions(FILE* fptr, FILE* optr){
             sprintf(offset_str, "%d", offset_val);
             
             int check = j_cmds(instr_name, rd, offset_str, optr, current_address);
-            if(!check) break;
+            if(!check){
+                sen = 0;
+                break;
+            }
+            current_address += 4;
+            continue;
+        }
+        // Handling the region-of-interest markers, roi_begin is addi x0 x0 1 and roi_end is addi x0 x0 2
+        if(strcmp(instr_name, "roi_begin") == 0 || strcmp(instr_name, "roi_end") == 0){
+            if(strtok(NULL, ", \t\n") != NULL) printf("Warning: Excess tokens detected in line %d...ignoring and proceeding with execution\n", line_num);
+            if(!i_cmds_1("addi", "x0", "x0", strcmp(instr_name, "roi_begin") == 0 ? "1" : "2", optr, line_num)){
+                sen = 0;
+                break;
+            }
+            current_address += 4;
+            continue;
+        }
+        // Handling the counter read pseudo-instructions
+        for(int i = 0; i < sizeof(csr_reads) / sizeof(csr_pseudo); i++){
+            if(strcmp(instr_name, csr_reads[i].name) == 0){
+                char* rd = strtok(NULL, ", \t\n");
+                handled = 1;
+                if(rd == NULL){
+                    fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+                    sen = 0;
+                    break;
+                }
+                if(strtok(NULL, ", \t\n") != NULL) printf("Warning: Excess tokens detected in line %d...ignoring and proceeding with execution\n", line_num);
+                if(!csr_cmds("csrrs", rd, csr_reads[i].csr, "x0", optr, line_num)) sen = 0;
+                break;
+            }
+        }
+        if(sen == 0) break;
+        if(handled){
             current_address += 4;
             continue;
         }
@@ -799,6 +977,7 @@ void process_instructions(FILE* fptr, FILE* optr){
         char* rd_or_rs2 = strtok(NULL, ", \t\n");
         if(rd_or_rs2 == NULL){
             fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+            sen = 0;
             break;
         }
         if(rd_or_rs2[strlen(rd_or_rs2) - 1] == ')' && rd_or_rs2[0] == '('){
@@ -810,6 +989,7 @@ void process_instructions(FILE* fptr, FILE* optr){
         char* rs1_or_offset = strtok(NULL, ", \t\n");
         if(rs1_or_offset == NULL){
             fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+            sen = 0;
             break;
         }
         if(rs1_or_offset[strlen(rs1_or_offset) - 1] == ')' && rs1_or_offset[0] == '('){
@@ -825,8 +1005,9 @@ void process_instructions(FILE* fptr, FILE* optr){
             }
         }
 
-        long imm_value;
-        if(strncasecmp(rs2_or_offset, "0x", 2) == 0){
+        long imm_value = 0;
+        if(rs2_or_offset == NULL) imm_value = 0;   // Two operand forms such as ld x6 0(x5)
+        else if(strncasecmp(rs2_or_offset, "0x", 2) == 0){
             imm_value = strtol(rs2_or_offset, NULL, 16);  // Converting hexadecimals to long ints
         }
         else{
@@ -853,6 +1034,31 @@ void process_instructions(FILE* fptr, FILE* optr){
             }
         }
 
+        // Process Zicsr instructions, csrr rd csr and csrw csr rs1 are shorthands for csrrs and csrrw
+        if(!handled && strcmp(instr_name, "csrr") == 0){
+            if(!csr_cmds("csrrs", rd_or_rs2, rs1_or_offset, "x0", optr, line_num)) sen = 0;
+            handled = 1;
+        }
+        if(!handled && strcmp(instr_name, "csrw") == 0){
+            if(!csr_cmds("csrrw", "x0", rd_or_rs2, rs1_or_offset, optr, line_num)) sen = 0;
+            handled = 1;
+        }
+        if(!handled){
+            for(int i = 0; i < sizeof(csr_instructions) / sizeof(csr_format); i++){
+                if(strcmp(instr_name, csr_instructions[i].name) == 0){
+                    if(rs2_or_offset == NULL){
+                        fprintf(stderr, "Error in line %d\nMissing argument(s)\n", line_num);
+                        sen = 0;
+                        handled = 1;
+                        break;
+                    }
+                    if(!csr_cmds(instr_name, rd_or_rs2, rs1_or_offset, rs2_or_offset, optr, line_num)) sen = 0;
+                    handled = 1;
+                    break;
+                }
+            }
+        }
+
         // Process R-format instructions
         if(!handled){
             for (int i = 0; i < sizeof(r_instructions) / sizeof(r_format); i++) {
@@ -963,8 +1169,10 @@ void process_instructions(FILE* fptr, FILE* optr){
         // If no instruction was handled, report an error
         if(!handled){
             fprintf(stderr, "Error in line %d\nUnknown instruction: %s\n", line_num, instr_name);
+            sen = 0;
             break;
         }
         current_address += 4; // Increment address by 4 bytes for each instruction
     }
+    return sen;     // 1 only if every line was encoded
 }
\ No newline at end of file
@@ -3,20 +3,38 @@
 #ifndef ASSEMBLER_H
 #define ASSEMBLER_H
 
-#define MAX_LABEL_LEN 10
+#define MAX_LABEL_LEN 32
 #define MAX_LINE_LEN 100
 #define NUM_REGS 32
 #define TEXT_START 0x0
 #define DATA_START 0x10000
 #define STACK_START 0x50000
 #define MAX_LINES 64
+#define MAX_LABELS 1024     // Also holds function symbols of ELF executables
+#define MAX_INSTRS (DATA_START / 4)     // One line table entry per word of the text section
+#define ASSEMBLER_VERSION "1.4"    // Bump whenever the encoding or the line table changes, invalidates cached programs
+
+// Zicsr counter CSRs, hpmcounter3 to hpmcounter31 follow hpmcounter3
+#define CSR_CYCLE 0xc00
+#define CSR_TIME 0xc01
+#define CSR_INSTRET 0xc02
+#define CSR_HPMCOUNTER3 0xc03
+#define CSR_HPMCOUNTER31 0xc1f
+
+// Region-of-interest markers, hint encodings of addi x0 x0 imm
+#define ROI_BEGIN_WORD 0x00100013
+#define ROI_END_WORD 0x00200013
 
 typedef struct{
     char name[MAX_LABEL_LEN];
     int address;
 } label_info;
 
-extern label_info labels[MAX_LINES];
+extern label_info labels[MAX_LABELS];
+extern int label_count;
+extern label_info data_labels[MAX_LABELS];    // Labels of the .data section and ELF data symbols, by address
+extern int data_label_count;
+extern unsigned data_end;       // End of the initialized data image
 
 int r_cmds(char* inst_name, char* rd, char* rs1, char* rs2, FILE* optr, int line_num);
 int i_cmds_1(char* instr_name, char* rd, char* rs1, char* imm, FILE* optr, int line_num);
@@ -25,7 +43,9 @@ int s_cmds(char* inst_name, char* rs2, char* rs1_or_offset, char* optional_rs1,
 int b_cmds(char* inst_name, char* rs1, char* rs2, char* offset, FILE* optr, int line_num);
 int j_cmds(char* inst_name, char* rd, char* offset_str, FILE* optr, int line_num);
 int u_cmds(char* rd, char* imm, char* opcode, FILE* optr, int line_num);
+int csr_cmds(char* inst_name, char* rd, char* csr, char* source, FILE* optr, int line_num);
+int skip_data_line(const char* line, int* in_data);
 int parse_labels(FILE* fptr);
-void process_instructions(FILE* fptr, FILE* optr);
+int process_instructions(FILE* fptr, FILE* optr);
 
 #endif
\ No newline at end of file
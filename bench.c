@@ -0,0 +1,145 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include "simulator.h"
+#include "cache.h"
+#include "bench.h"
+
+// Function to hash all of data memory with FNV-1a, one byte per guest address
+unsigned long long memory_checksum(){
+    unsigned long long hash = 14695981039346656037ULL;
+    for(int i = 0; i < STACK_START - DATA_START; i++){
+        hash ^= data_section[i] & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to parse the rest of a "kernel <name> <file> x10=<value> ... mem=<value>" manifest line
+int parse_kernel(bench_kernel* kernel, int line_num){
+    char* name = strtok(NULL, " \t\n");
+    char* file = strtok(NULL, " \t\n");
+    if(name == NULL || file == NULL){
+        printf("Error: Manifest line %d needs a kernel name and file\n", line_num);
+        return 0;
+    }
+    snprintf(kernel->name, sizeof(kernel->name), "%s", name);
+    snprintf(kernel->file, sizeof(kernel->file), "%s", file);
+    kernel->check_count = 0;
+    char* check;
+    while((check = strtok(NULL, " \t\n")) != NULL){
+        char* equals = strchr(check, '=');
+        if(equals == NULL || kernel->check_count == BENCH_MAX_CHECKS){
+            printf("Error: Bad check %s on manifest line %d\n", check, line_num);
+            return 0;
+        }
+        *equals = '\0';
+        int reg;
+        if(strcmp(check, "mem") == 0) reg = -1;
+        else if(sscanf(check, "x%d", &reg) != 1 || reg < 0 || reg >= NUM_REGS){
+            printf("Error: Unknown register %s on manifest line %d\n", check, line_num);
+            return 0;
+        }
+        kernel->check_regs[kernel->check_count] = reg;
+        kernel->check_values[kernel->check_count] = strtoull(equals + 1, NULL, 0);
+        kernel->check_count++;
+    }
+    return 1;
+}
+
+// Function to compare the final state of a kernel with its expected checksums
+int kernel_correct(bench_kernel* kernel){
+    for(int i = 0; i < kernel->check_count; i++){
+        long long actual = kernel->check_regs[i] < 0 ? (long long)memory_checksum() : registers[kernel->check_regs[i]];
+        if(actual != kernel->check_values[i]) return 0;
+    }
+    return 1;
+}
+
+// Runs every kernel of the manifest without a cache and under each cache configuration
+void run_benchmarks(const char* manifest){
+    /*
+    The manifest lists cache configuration files ("cache <file>") and kernels with their expected
+    final register values and memory checksum ("kernel <name> <file> x10=<value> mem=<value>")
+    Results are collected and printed as one table because loading a kernel prints its own messages
+    */
+    FILE* fptr = fopen(manifest, "r");
+    if(fptr == NULL){
+        printf("Error: Cannot open benchmark manifest %s\n", manifest);
+        return;
+    }
+    char configs[BENCH_MAX_CONFIGS][256];
+    int config_count = 0;
+    bench_kernel* kernels = NULL;
+    int kernel_count = 0;
+    char line[512];
+    int line_num = 0, valid = 1;
+    while(fgets(line, sizeof(line), fptr) && valid){
+        line_num++;
+        char* keyword = strtok(line, " \t\n");
+        if(keyword == NULL || keyword[0] == '#') continue;
+        if(strcmp(keyword, "cache") == 0){
+            char* file = strtok(NULL, " \t\n");
+            if(file == NULL || config_count == BENCH_MAX_CONFIGS){
+                printf("Error: Bad cache line %d in %s\n", line_num, manifest);
+                valid = 0;
+            }
+            else snprintf(configs[config_count++], 256, "%s", file);
+        }
+        else if(strcmp(keyword, "kernel") == 0){
+            kernels = realloc(kernels, (kernel_count + 1) * sizeof(bench_kernel));
+            valid = parse_kernel(&kernels[kernel_count++], line_num);
+        }
+        else{
+            printf("Error: Unknown manifest entry %s on line %d\n", keyword, line_num);
+            valid = 0;
+        }
+    }
+    fclose(fptr);
+    if(!valid || kernel_count == 0){
+        if(valid) printf("Error: No kernels in %s\n", manifest);
+        free(kernels);
+        return;
+    }
+
+    int runs = kernel_count * (config_count + 1);
+    char (*rows)[160] = malloc(runs * sizeof(*rows));
+    int row_count = 0, failures = 0;
+    for(int k = 0; k < kernel_count; k++){
+        for(int c = -1; c < config_count; c++){
+            load(kernels[k].file);
+            if(instr_count == 0){
+                snprintf(rows[row_count++], 160, "%-16s %-24s %s", kernels[k].name, c < 0 ? "none" : configs[c], "LOAD FAILED");
+                failures++;
+                continue;
+            }
+            if(c >= 0) enable_cache(configs[c]);
+            else cache_enabled = 0;
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            long long executed = run_quiet(BENCH_MAX_INSTRUCTIONS);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+            int finished = pc >= (unsigned)instr_count * 4;
+            if(finished && stack_top >= 0) pop_stack();
+            if(cache_enabled) flush_cache();    // Write-back data has to reach memory before it is hashed
+
+            int correct = finished && kernel_correct(&kernels[k]);
+            failures += !correct;
+            char hit_rate[16] = "-";
+            if(cache_enabled && cache_accesses > 0) snprintf(hit_rate, sizeof(hit_rate), "%.4f", (double)cache_hits / cache_accesses);
+            const char* config_name = c < 0 ? "none" : strrchr(configs[c], '/') ? strrchr(configs[c], '/') + 1 : configs[c];
+            snprintf(rows[row_count++], 160, "%-16s %-24s %12lld %10.4f %10.2f %9s  %s", kernels[k].name, config_name, executed,
+                     seconds, seconds > 0 ? executed / seconds / 1e6 : 0.0, hit_rate, !finished ? "HUNG" : correct ? "OK" : "WRONG");
+        }
+    }
+    cache_enabled = 0;
+
+    printf("%-16s %-24s %12s %10s %10s %9s  %s\n", "Kernel", "Cache", "Instructions", "Seconds", "Host MIPS", "Hit rate", "Result");
+    for(int i = 0; i < row_count; i++) printf("%s\n", rows[i]);
+    printf("%d of %d runs correct\n", runs - failures, runs);
+    free(rows);
+    free(kernels);
+}
\ No newline at end of file
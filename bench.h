@@ -0,0 +1,22 @@
+#include <stdio.h>
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#define BENCH_MANIFEST "benchmarks/manifest.txt"
+#define BENCH_MAX_CONFIGS 8
+#define BENCH_MAX_CHECKS 8
+#define BENCH_MAX_INSTRUCTIONS 500000000LL    // A kernel still running after this many is reported as hung
+
+typedef struct{
+    char name[32];
+    char file[256];
+    int check_count;
+    int check_regs[BENCH_MAX_CHECKS];           // Registers to compare, -1 for the memory checksum
+    long long check_values[BENCH_MAX_CHECKS];
+} bench_kernel;
+
+void run_benchmarks(const char* manifest);
+unsigned long long memory_checksum();
+
+#endif
\ No newline at end of file
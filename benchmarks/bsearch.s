@@ -0,0 +1,40 @@
+# Binary search over 1024 sorted doublewords a[i] = 3i + 1 at 0x10000
+# The keys are 0, 5, 10, ..., 3070
+# x10 = sum of (index + 1) over the keys found, x11 = keys found
+lui x2 80
+lui x20 16
+addi x5 x20 0
+addi x6 x0 1
+addi x8 x0 1024
+fill: sd x6 0(x5)
+addi x6 x6 3
+addi x5 x5 8
+addi x8 x8 -1
+bne x8 x0 fill
+roi_begin
+addi x10 x0 0
+addi x11 x0 0
+addi x12 x0 0
+addi x13 x0 1025
+add x7 x13 x13
+add x13 x13 x7
+search: addi x14 x0 0
+addi x15 x0 1024
+probe: bge x14 x15 next
+add x16 x14 x15
+srli x16 x16 1
+slli x5 x16 3
+add x5 x5 x20
+ld x6 0(x5)
+beq x6 x12 found
+blt x6 x12 upper
+addi x15 x16 0
+beq x0 x0 probe
+upper: addi x14 x16 1
+beq x0 x0 probe
+found: addi x16 x16 1
+add x10 x10 x16
+addi x11 x11 1
+next: addi x12 x12 5
+bne x12 x13 search
+roi_end
@@ -0,0 +1,144 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<time.h>
+#include "../cache.h"
+#include "../simulator.h"
+#include "../assembler.h"
+#include "../pipeline.h"
+#include "../ooo.h"
+#include "../vm.h"
+
+/*
+Standalone microbenchmark of the cache model, it drives cache_read() and cache_write() with synthetic
+address streams instead of running a program, so it measures the cost of the cache hot path alone
+Build from the repository root with: gcc -O2 -o cache_bench benchmarks/cache_bench.c cache.c prefetcher.c cache_buffers.c miss_classifier.c heatmap.c dram.c -lm
+Usage: ./cache_bench [accesses per run]
+*/
+
+#define DEFAULT_ACCESSES (1 << 20)
+#define BENCH_CACHE_SIZE 16384      // Every configuration of the sweep has this capacity
+#define WRITE_EVERY 4               // One access in four is a store
+
+long long int data_section[STACK_START - DATA_START];  // The simulator state the cache model and its helpers touch
+int instr_count;
+char instructions[MAX_INSTRS][MAX_LINE_LEN];
+int instruction_lines[MAX_INSTRS];
+label_info data_labels[MAX_LABELS];
+int data_label_count;
+unsigned data_end;
+int pipeline_enabled, ooo_enabled;    // The DRAM model reads the core clock only when a timing model is on
+pipeline_stats pipe_stats;
+long long dispatch_cycle;
+unsigned char page_table_memory[PAGE_TABLE_SIZE];
+
+typedef struct{
+    const char* name;
+    unsigned* addresses;
+} address_stream;
+
+unsigned long long rng_state = 0x9e3779b97f4a7c15ULL;
+
+// Function to return the next value of a xorshift generator, fixed seed so runs are comparable
+unsigned long long next_random(){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Function to fill a stream with addresses following one of the access patterns
+void generate_stream(unsigned* addresses, int count, const char* pattern){
+    unsigned region = STACK_START - DATA_START - 8;   // Leaves room for the widest access
+    int blocks = (STACK_START - DATA_START) / 64;
+    double* cdf = NULL;
+    if(strcmp(pattern, "zipf") == 0){
+        // Block ranks are drawn with probability proportional to 1 / rank^0.99
+        cdf = malloc(blocks * sizeof(double));
+        double total = 0;
+        for(int i = 0; i < blocks; i++) cdf[i] = total += 1.0 / pow(i + 1, 0.99);
+        for(int i = 0; i < blocks; i++) cdf[i] /= total;
+    }
+    for(int i = 0; i < count; i++){
+        unsigned offset;
+        if(strcmp(pattern, "sequential") == 0) offset = (i * 8u) % region;
+        else if(strcmp(pattern, "strided") == 0) offset = (i * 4104u) % region;    // A page and a block apart
+        else if(strcmp(pattern, "random") == 0) offset = next_random() % region;
+        else if(strcmp(pattern, "working_set") == 0) offset = next_random() % BENCH_CACHE_SIZE;
+        else{
+            double u = (double)(next_random() >> 11) / (1ULL << 53);
+            int low = 0, high = blocks - 1;
+            while(low < high){
+                int mid = (low + high) / 2;
+                if(cdf[mid] < u) low = mid + 1;
+                else high = mid;
+            }
+            // Scattering the ranks over memory so popular blocks are not neighbours
+            offset = ((low * 2654435761u) % blocks) * 64 + (next_random() % 8) * 8;
+        }
+        addresses[i] = DATA_START + (offset & ~7u);
+    }
+    free(cdf);
+}
+
+// Function to time one stream through the current cache configuration, returns nanoseconds per access
+double time_stream(unsigned* addresses, int count){
+    initialize_cache();
+    cache_accesses = cache_hits = cache_misses = cache_clock = 0;
+    long long data, checksum = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < count; i++){
+        if(i % WRITE_EVERY == WRITE_EVERY - 1) cache_write(addresses[i], i, 3);
+        else{
+            cache_read(addresses[i], 3, &data);
+            checksum += data;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(checksum == 42) printf(" ");     // Keeps the loads from being optimized away
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / count;
+}
+
+int main(int argc, char* argv[]){
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_ACCESSES;
+    if(count <= 0){
+        printf("Usage: %s [accesses per run]\n", argv[0]);
+        return 1;
+    }
+    const char* patterns[] = {"sequential", "strided", "random", "zipf", "working_set"};
+    int pattern_count = sizeof(patterns) / sizeof(patterns[0]);
+    address_stream streams[5];
+    for(int i = 0; i < pattern_count; i++){
+        streams[i].name = patterns[i];
+        streams[i].addresses = malloc(count * sizeof(unsigned));
+        generate_stream(streams[i].addresses, count, patterns[i]);
+    }
+
+    const int block_sizes[] = {32, 64};
+    const int associativities[] = {1, 2, 4, 8};
+    const char* policies[] = {"LRU", "FIFO", "LFU", "RANDOM", "PLRU", "SRRIP", "BRRIP", "DIP"};
+    int policy_count = sizeof(policies) / sizeof(policies[0]);
+    strcpy(write_back_policy, "WB");
+    cache_size = BENCH_CACHE_SIZE;
+
+    printf("%d accesses per run, %d byte cache, write-back\n", count, BENCH_CACHE_SIZE);
+    printf("%-12s %6s %6s %-7s %10s %14s %9s\n", "Stream", "Block", "Ways", "Policy", "ns/access", "Accesses/s", "Hit rate");
+    for(int s = 0; s < pattern_count; s++){
+        for(int b = 0; b < 2; b++){
+            for(int a = 0; a < 4; a++){
+                for(int p = 0; p < policy_count; p++){
+                    block_size = block_sizes[b];
+                    associativity = associativities[a];
+                    strcpy(replacement_policy, policies[p]);
+                    double ns = time_stream(streams[s].addresses, count);
+                    printf("%-12s %6d %6d %-7s %10.2f %14.0f %9.4f\n", streams[s].name, block_size, associativity,
+                           replacement_policy, ns, 1e9 / ns, (double)cache_hits / cache_accesses);
+                }
+            }
+        }
+    }
+    for(int i = 0; i < pattern_count; i++) free(streams[i].addresses);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+# Naive recursive Fibonacci, fib(20) with a 24-byte stack frame per call
+# x10 = fib(20)
+lui x2 80
+roi_begin
+addi x10 x0 20
+jal x1 fib
+roi_end
+beq x0 x0 done
+fib: addi x2 x2 -24
+sd x1 16(x2)
+sd x10 8(x2)
+addi x5 x0 2
+blt x10 x5 base
+addi x10 x10 -1
+jal x1 fib
+sd x10 0(x2)
+ld x10 8(x2)
+addi x10 x10 -2
+jal x1 fib
+ld x5 0(x2)
+add x10 x10 x5
+ld x1 16(x2)
+addi x2 x2 24
+jalr x0 0(x1)
+base: ld x1 16(x2)
+addi x2 x2 24
+jalr x0 0(x1)
+done: addi x0 x0 0
@@ -0,0 +1,33 @@
+# Pointer chasing through 1024 nodes of 64 bytes at 0x10000
+# Node k of the walk sits at index 389k mod 1024 and holds k
+# Every step depends on the load before it
+# x10 = sum of the values visited in 8 rounds
+lui x2 80
+lui x20 16
+addi x5 x0 0
+addi x6 x0 0
+addi x8 x0 1024
+build: addi x7 x5 389
+andi x7 x7 1023
+slli x9 x5 6
+add x9 x9 x20
+slli x11 x7 6
+add x11 x11 x20
+sd x11 0(x9)
+sd x6 8(x9)
+addi x6 x6 1
+addi x5 x7 0
+addi x8 x8 -1
+bne x8 x0 build
+roi_begin
+addi x10 x0 0
+addi x12 x0 8
+round: addi x8 x0 1024
+chase: ld x6 8(x20)
+add x10 x10 x6
+ld x20 0(x20)
+addi x8 x8 -1
+bne x8 x0 chase
+addi x12 x12 -1
+bne x12 x0 round
+roi_end
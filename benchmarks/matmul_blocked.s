@@ -0,0 +1,81 @@
+# 16x16 doubleword matrix multiply C = A * B in 4x4 blocks
+# C is accumulated in memory
+# A[i][j] = i + j + 1 at 0x10000, B[i][j] = i + 2j + 1 at 0x10800
+# C at 0x11000
+# Products use the RV64M mul instruction
+# x10 = sum of C
+lui x2 80
+lui x20 16
+addi x21 x20 2047
+addi x21 x21 1
+addi x22 x21 2047
+addi x22 x22 1
+addi x23 x0 0
+initrow: addi x24 x0 0
+initcol: slli x5 x23 7
+slli x6 x24 3
+add x5 x5 x6
+add x6 x5 x20
+add x7 x23 x24
+addi x7 x7 1
+sd x7 0(x6)
+add x6 x5 x21
+add x7 x23 x24
+add x7 x7 x24
+addi x7 x7 1
+sd x7 0(x6)
+addi x24 x24 1
+addi x5 x0 16
+bne x24 x5 initcol
+addi x23 x23 1
+bne x23 x5 initrow
+roi_begin
+addi x14 x0 0
+iiloop: addi x15 x0 0
+jjloop: addi x16 x0 0
+kkloop: addi x23 x14 0
+addi x17 x14 4
+iloop: addi x24 x15 0
+addi x18 x15 4
+jloop: slli x5 x23 7
+slli x6 x24 3
+add x5 x5 x6
+add x27 x5 x22
+ld x26 0(x27)
+addi x25 x16 0
+addi x19 x16 4
+kloop: slli x5 x23 7
+slli x6 x25 3
+add x5 x5 x6
+add x5 x5 x20
+ld x10 0(x5)
+slli x5 x25 7
+slli x6 x24 3
+add x5 x5 x6
+add x5 x5 x21
+ld x11 0(x5)
+mul x10 x10 x11
+add x26 x26 x10
+addi x25 x25 1
+bne x25 x19 kloop
+sd x26 0(x27)
+addi x24 x24 1
+bne x24 x18 jloop
+addi x23 x23 1
+bne x23 x17 iloop
+addi x5 x0 16
+addi x16 x16 4
+bne x16 x5 kkloop
+addi x15 x15 4
+bne x15 x5 jjloop
+addi x14 x14 4
+bne x14 x5 iiloop
+roi_end
+addi x10 x0 0
+addi x8 x0 256
+addi x5 x22 0
+check: ld x6 0(x5)
+add x10 x10 x6
+addi x5 x5 8
+addi x8 x8 -1
+bne x8 x0 check
@@ -0,0 +1,32 @@
+# Streaming copy of 4096 doublewords (32 KiB) from 0x10000 to 0x20000
+# x10 = sum of the destination
+lui x2 80
+lui x5 16
+addi x6 x0 1
+lui x8 1
+fill: sd x6 0(x5)
+addi x6 x6 3
+addi x5 x5 8
+addi x8 x8 -1
+bne x8 x0 fill
+roi_begin
+lui x5 16
+lui x9 32
+lui x8 1
+copy: ld x6 0(x5)
+ld x7 8(x5)
+sd x6 0(x9)
+sd x7 8(x9)
+addi x5 x5 16
+addi x9 x9 16
+addi x8 x8 -2
+bne x8 x0 copy
+roi_end
+lui x9 32
+lui x8 1
+addi x10 x0 0
+check: ld x6 0(x9)
+add x10 x10 x6
+addi x9 x9 8
+addi x8 x8 -1
+bne x8 x0 check
@@ -0,0 +1,37 @@
+# Stores that are still held by the cache model when the timing thread takes over
+# A ends up dirty in the victim cache, B dirty in the cache and C, D in the write buffer
+# The interpreter reads memory directly once offloaded, so every load has to see its store
+# x10 = loads that returned the stored value (4)
+# Regression sequence, switching the timing thread on in the middle of the run:
+#   cache_sim enable benchmarks/cache_dm_4k.txt
+#   victim_cache enable 4
+#   write_buffer enable 2
+#   load benchmarks/offload_store.s
+#   break 24
+#   run
+#   del break 24
+#   timing_thread enable
+#   run
+lui x5 16
+lui x7 17
+lui x8 18
+lui x9 19
+addi x6 x0 77
+sd x6 0(x5)
+sd x6 0(x7)
+sd x6 0(x8)
+sd x6 0(x9)
+addi x10 x0 0
+ld x11 0(x5)
+bne x11 x6 lost_a
+addi x10 x10 1
+lost_a: ld x11 0(x7)
+bne x11 x6 lost_b
+addi x10 x10 1
+lost_b: ld x11 0(x8)
+bne x11 x6 lost_c
+addi x10 x10 1
+lost_c: ld x11 0(x9)
+bne x11 x6 lost_d
+addi x10 x10 1
+lost_d: addi x0 x0 0
@@ -0,0 +1,791 @@
+# RV64IM conformance kernel, every result is compared with the value the ISA defines
+# Expected results are in .data, check counts matches in x10 and mismatches in x11
+# x5 = -7, x6 = 3, x7 = 0x123456789abcdef0, x8 = INT64_MIN, x9 = 0xffffffff
+# x18 = 65, x19 = 0x7fffffff, x22 = -1, x23 = INT32_MIN
+# The scratch doubleword for loads and stores is at 0x10000
+.data
+scratch: .dword 0
+operands: .dword -7, 3, 1311768467463790320, -9223372036854775808, 4294967295, 65
+.dword 2147483647
+expected: .dword 1311768467463790313, -1311768467463790327, 1311768467463790320
+.dword 1311768467463790323, -1311768467463790327, 2623536934927580640
+.dword 4611686018427387904, -4611686018427387904, -7952596333999229056
+.dword 2305843009213693951, -1, 655884233731895160, 1, 0, 0, 1, 1, 1, -2147483646, -3
+.dword -2, 536870911, -1, -1698898199, -849449096, 1298034552, -9182379272246532240, -1
+.dword -1, 1311768467463790319, 4611686018427387904, 4611686018427387904
+.dword -9223372036854775808, -9223372036854775808, -9223372036854775808, 0, -2
+.dword 6148914691236517203, -1, 0, -1, -1, -7, -7, 1, -992614544, -2, 1431655763, -1, 0
+.dword -2147483648, 0, -1, -7, -1, -7, -2055, 1311768467463792367, 1, 0, 1, 1, 0, 1, 6
+.dword -2045, 1776, -16, 0, 3298534883328, 15, 1, -1, 19088743, -4, -2147483648
+.dword -1698898192, -2055, -2147483648, 268435455, -1, -1, 1, -1412567296, -4096
+.dword -2147483648, 4836, 748, 44, 1311768467463790320, -16, 240, -34, -25924, 39612
+.dword 305419896, 305419896, -1698898192, 4660, -30064510480, 0
+.text
+lui x21 16
+addi x20 x21 64
+ld x5 8(x21)
+ld x6 16(x21)
+ld x7 24(x21)
+ld x8 32(x21)
+ld x9 40(x21)
+ld x18 48(x21)
+ld x19 56(x21)
+addi x22 x0 -1
+addiw x23 x19 1
+addi x10 x0 0
+addi x11 x0 0
+add x12 x5 x7
+jal x1 check
+sub x12 x5 x7
+jal x1 check
+and x12 x7 x5
+jal x1 check
+or x12 x7 x6
+jal x1 check
+xor x12 x7 x5
+jal x1 check
+sll x12 x7 x18
+jal x1 check
+srl x12 x8 x18
+jal x1 check
+sra x12 x8 x18
+jal x1 check
+sll x12 x7 x6
+jal x1 check
+srl x12 x5 x6
+jal x1 check
+sra x12 x5 x6
+jal x1 check
+sra x12 x7 x18
+jal x1 check
+slt x12 x5 x6
+jal x1 check
+slt x12 x6 x5
+jal x1 check
+sltu x12 x5 x6
+jal x1 check
+sltu x12 x6 x5
+jal x1 check
+slt x12 x8 x6
+jal x1 check
+sltu x12 x9 x7
+jal x1 check
+addw x12 x19 x6
+jal x1 check
+subw x12 x8 x6
+jal x1 check
+sllw x12 x19 x18
+jal x1 check
+srlw x12 x5 x6
+jal x1 check
+sraw x12 x5 x6
+jal x1 check
+addw x12 x7 x5
+jal x1 check
+sraw x12 x7 x18
+jal x1 check
+srlw x12 x7 x18
+jal x1 check
+mul x12 x5 x7
+jal x1 check
+mulh x12 x5 x7
+jal x1 check
+mulhsu x12 x5 x7
+jal x1 check
+mulhu x12 x5 x7
+jal x1 check
+mulh x12 x8 x8
+jal x1 check
+mulhu x12 x8 x8
+jal x1 check
+mulhsu x12 x8 x22
+jal x1 check
+mul x12 x8 x22
+jal x1 check
+div x12 x8 x22
+jal x1 check
+rem x12 x8 x22
+jal x1 check
+div x12 x5 x6
+jal x1 check
+divu x12 x5 x6
+jal x1 check
+rem x12 x5 x6
+jal x1 check
+remu x12 x5 x6
+jal x1 check
+div x12 x5 x0
+jal x1 check
+divu x12 x5 x0
+jal x1 check
+rem x12 x5 x0
+jal x1 check
+remu x12 x5 x0
+jal x1 check
+mulw x12 x19 x19
+jal x1 check
+mulw x12 x7 x5
+jal x1 check
+divw x12 x5 x6
+jal x1 check
+divuw x12 x5 x6
+jal x1 check
+remw x12 x5 x6
+jal x1 check
+remuw x12 x5 x6
+jal x1 check
+divw x12 x23 x22
+jal x1 check
+remw x12 x23 x22
+jal x1 check
+divw x12 x5 x0
+jal x1 check
+remw x12 x5 x0
+jal x1 check
+divuw x12 x5 x0
+jal x1 check
+remuw x12 x5 x0
+jal x1 check
+addi x12 x5 -2048
+jal x1 check
+addi x12 x7 2047
+jal x1 check
+slti x12 x5 -6
+jal x1 check
+slti x12 x5 -8
+jal x1 check
+sltiu x12 x5 -1
+jal x1 check
+sltiu x12 x6 -1
+jal x1 check
+sltiu x12 x5 5
+jal x1 check
+slti x12 x8 0
+jal x1 check
+xori x12 x5 -1
+jal x1 check
+ori x12 x6 -2048
+jal x1 check
+andi x12 x7 2047
+jal x1 check
+andi x12 x5 -16
+jal x1 check
+slli x12 x7 63
+jal x1 check
+slli x12 x6 40
+jal x1 check
+srli x12 x5 60
+jal x1 check
+srli x12 x8 63
+jal x1 check
+srai x12 x8 63
+jal x1 check
+srai x12 x7 36
+jal x1 check
+srai x12 x5 1
+jal x1 check
+addiw x12 x19 1
+jal x1 check
+addiw x12 x7 0
+jal x1 check
+addiw x12 x5 -2048
+jal x1 check
+slliw x12 x6 31
+jal x1 check
+srliw x12 x5 4
+jal x1 check
+sraiw x12 x5 4
+jal x1 check
+sraiw x12 x7 31
+jal x1 check
+srliw x12 x7 31
+jal x1 check
+slliw x12 x7 4
+jal x1 check
+lui x12 1048575
+jal x1 check
+lui x12 524288
+jal x1 check
+auipc x12 1
+jal x1 check
+auipc x12 0
+jal x1 check
+addi x12 x0 0
+bltu x9 x7 ult
+addi x12 x12 1
+ult: bgeu x7 x9 uge
+addi x12 x12 2
+uge: bltu x7 x9 unot
+addi x12 x12 4
+unot: bgeu x9 x7 gnot
+addi x12 x12 8
+gnot: blt x5 x6 slt_taken
+addi x12 x12 16
+slt_taken: bge x8 x5 sge_not
+addi x12 x12 32
+sge_not: addi x0 x0 0
+jal x1 check
+sd x7 0(x21)
+ld x12 0(x21)
+jal x1 check
+lb x12 0(x21)
+jal x1 check
+lbu x12 0(x21)
+jal x1 check
+lb x12 1(x21)
+jal x1 check
+lh x12 2(x21)
+jal x1 check
+lhu x12 2(x21)
+jal x1 check
+lw x12 4(x21)
+jal x1 check
+lwu x12 4(x21)
+jal x1 check
+lw x12 0(x21)
+jal x1 check
+lhu x12 6(x21)
+jal x1 check
+sb x5 1(x21)
+sh x6 2(x21)
+sw x5 4(x21)
+ld x12 0(x21)
+jal x1 check
+# The 520 instructions of padding make the branches across them longer than 2 KiB,
+# which needs imm[11] of the B and J formats (the calls of check cross it as well)
+# beq jumps forward over the padding, far jumps back to run it exactly once
+addi x12 x0 -520
+beq x0 x0 far
+pad: addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+addi x12 x12 1
+beq x0 x0 padded
+far: beq x0 x0 pad
+padded: addi x0 x0 0
+jal x1 check
+beq x0 x0 done
+check: ld x13 0(x20)
+addi x20 x20 8
+beq x12 x13 pass
+addi x11 x11 1
+jalr x0 0(x1)
+pass: addi x10 x10 1
+jalr x0 0(x1)
+done: addi x0 x0 0
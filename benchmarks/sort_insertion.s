@@ -0,0 +1,51 @@
+# Insertion sort of 256 doublewords at 0x10000
+# The data is x = (5x + 1) mod 65536 starting from 2047
+# x10 = sum of (a[i] xor i), x11 = adjacent pairs out of order
+lui x2 80
+lui x20 16
+lui x9 16
+addi x9 x9 -1
+addi x6 x0 2047
+addi x5 x20 0
+addi x8 x0 256
+fill: slli x7 x6 2
+add x6 x6 x7
+addi x6 x6 1
+and x6 x6 x9
+sd x6 0(x5)
+addi x5 x5 8
+addi x8 x8 -1
+bne x8 x0 fill
+roi_begin
+addi x12 x20 8
+addi x13 x0 2047
+addi x13 x13 1
+add x13 x13 x20
+outer: ld x14 0(x12)
+addi x15 x12 -8
+inner: blt x15 x20 place
+ld x16 0(x15)
+bge x14 x16 place
+sd x16 8(x15)
+addi x15 x15 -8
+beq x0 x0 inner
+place: sd x14 8(x15)
+addi x12 x12 8
+bne x12 x13 outer
+roi_end
+addi x10 x0 0
+addi x11 x0 0
+addi x5 x20 0
+addi x8 x0 0
+check: ld x6 0(x5)
+xor x7 x6 x8
+add x10 x10 x7
+addi x8 x8 1
+addi x7 x0 256
+beq x8 x7 done
+ld x7 8(x5)
+bge x7 x6 ordered
+addi x11 x11 1
+ordered: addi x5 x5 8
+beq x0 x0 check
+done: addi x0 x0 0
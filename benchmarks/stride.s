@@ -0,0 +1,24 @@
+# Strided reads, 16 passes over 512 doublewords 256 bytes apart (128 KiB)
+# x10 = sum of every value read
+lui x2 80
+lui x5 16
+addi x6 x0 1
+addi x8 x0 512
+fill: sd x6 0(x5)
+addi x6 x6 1
+addi x5 x5 256
+addi x8 x8 -1
+bne x8 x0 fill
+roi_begin
+addi x10 x0 0
+addi x11 x0 16
+pass: lui x5 16
+addi x8 x0 512
+walk: ld x6 0(x5)
+add x10 x10 x6
+addi x5 x5 256
+addi x8 x8 -1
+bne x8 x0 walk
+addi x11 x11 -1
+bne x11 x0 pass
+roi_end
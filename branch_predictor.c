@@ -0,0 +1,293 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include "simulator.h"
+#include "branch_predictor.h"
+
+int branch_predictor_enabled = 0;
+predictor_kind predictor = PREDICT_BIMODAL;
+int table_bits = 12;
+branch_stats bp_stats;
+
+/*
+Direction tables hold 2-bit saturating counters packed four to a byte
+TAGE entries pack a 3-bit counter, a 2-bit useful counter and an 8-bit tag into 16 bits
+*/
+uint8_t* bimodal_table = NULL;
+uint8_t* gshare_table = NULL;
+uint8_t* chooser_table = NULL;      // Counter >= 2 selects gshare
+uint16_t* tage_tables[TAGE_TABLES];
+const int tage_history[TAGE_TABLES] = {5, 11, 22, 44};
+uint64_t global_history = 0;        // Outcomes of the last 64 conditional branches, newest in bit 0
+long long tage_updates = 0;
+
+btb_entry btb[BTB_ENTRIES];
+unsigned ras[RAS_ENTRIES];
+int ras_top = 0;                    // Number of pushes, wraps around so deep recursion overwrites the oldest
+unsigned pc_executed[MAX_INSTRS];   // Per-branch-PC counts, indexed by pc/4
+unsigned pc_mispredicted[MAX_INSTRS];
+
+#define TAGE_CTR(entry) ((entry) & 7)
+#define TAGE_USEFUL(entry) (((entry) >> 3) & 3)
+#define TAGE_TAG(entry) (((entry) >> 5) & 0xff)
+#define TAGE_ENTRY(ctr, useful, tag) (uint16_t)((ctr) | ((useful) << 3) | ((tag) << 5))
+
+// Function to read the 2-bit counter at index from a packed table
+int get_counter(uint8_t* table, unsigned index){
+    return (table[index >> 2] >> ((index & 3) * 2)) & 3;
+}
+
+// Function to move the 2-bit counter at index towards the outcome
+void update_counter(uint8_t* table, unsigned index, int taken){
+    int value = get_counter(table, index);
+    if(taken && value < 3) value++;
+    else if(!taken && value > 0) value--;
+    int shift = (index & 3) * 2;
+    table[index >> 2] = (table[index >> 2] & ~(3 << shift)) | (value << shift);
+}
+
+// Function to fold the newest length bits of the global history down to bits bits
+unsigned fold_history(int length, int bits){
+    uint64_t history = length >= 64 ? global_history : global_history & ((1ULL << length) - 1);
+    unsigned folded = 0;
+    while(history){
+        folded ^= history & ((1u << bits) - 1);
+        history >>= bits;
+    }
+    return folded;
+}
+
+unsigned bimodal_index(unsigned pc){ return (pc >> 2) & ((1u << table_bits) - 1); }
+unsigned gshare_index(unsigned pc){ return ((pc >> 2) ^ global_history) & ((1u << table_bits) - 1); }
+unsigned tage_index(unsigned pc, int table){
+    int bits = table_bits - 2;
+    return ((pc >> 2) ^ (pc >> (bits + 2)) ^ fold_history(tage_history[table], bits)) & ((1u << bits) - 1);
+}
+unsigned tage_tag(unsigned pc, int table){
+    return ((pc >> 2) ^ fold_history(tage_history[table], 8) ^ (fold_history(tage_history[table], 7) << 1)) & 0xff;
+}
+
+// Function to predict and train the direction of a conditional branch, returns the predicted direction
+int predict_direction(unsigned pc, unsigned target, int taken){
+    int prediction = 0;
+    if(predictor == PREDICT_STATIC) return target < pc;
+
+    unsigned b = bimodal_index(pc), g = gshare_index(pc);
+    int bimodal = get_counter(bimodal_table, b) >= 2;
+    if(predictor == PREDICT_BIMODAL){
+        prediction = bimodal;
+        update_counter(bimodal_table, b, taken);
+    }
+    else if(predictor == PREDICT_GSHARE){
+        prediction = get_counter(gshare_table, g) >= 2;
+        update_counter(gshare_table, g, taken);
+    }
+    else if(predictor == PREDICT_TOURNAMENT){
+        int gshare = get_counter(gshare_table, g) >= 2;
+        prediction = get_counter(chooser_table, b) >= 2 ? gshare : bimodal;
+        if(gshare != bimodal) update_counter(chooser_table, b, gshare == taken);
+        update_counter(bimodal_table, b, taken);
+        update_counter(gshare_table, g, taken);
+    }
+    else{
+        // The longest matching table provides the prediction, the next one (or the bimodal table) is the alternative
+        int provider = -1, alternate = -1;
+        unsigned index[TAGE_TABLES], tag[TAGE_TABLES];
+        for(int t = TAGE_TABLES - 1; t >= 0; t--){
+            index[t] = tage_index(pc, t);
+            tag[t] = tage_tag(pc, t);
+            if(TAGE_TAG(tage_tables[t][index[t]]) != tag[t]) continue;
+            if(provider < 0) provider = t;
+            else if(alternate < 0) alternate = t;
+        }
+        int alternate_prediction = alternate >= 0 ? TAGE_CTR(tage_tables[alternate][index[alternate]]) >= 4 : bimodal;
+        prediction = provider >= 0 ? TAGE_CTR(tage_tables[provider][index[provider]]) >= 4 : bimodal;
+
+        if(provider >= 0){
+            uint16_t entry = tage_tables[provider][index[provider]];
+            int ctr = TAGE_CTR(entry), useful = TAGE_USEFUL(entry);
+            if(taken && ctr < 7) ctr++;
+            else if(!taken && ctr > 0) ctr--;
+            if(prediction != alternate_prediction){
+                if(prediction == taken && useful < 3) useful++;
+                else if(prediction != taken && useful > 0) useful--;
+            }
+            tage_tables[provider][index[provider]] = TAGE_ENTRY(ctr, useful, TAGE_TAG(entry));
+        }
+        else update_counter(bimodal_table, b, taken);
+
+        // A misprediction allocates an entry in a longer table, ageing the candidates if none is free
+        if(prediction != taken && provider < TAGE_TABLES - 1){
+            int allocated = 0;
+            for(int t = provider + 1; t < TAGE_TABLES && !allocated; t++){
+                if(TAGE_USEFUL(tage_tables[t][index[t]]) != 0) continue;
+                tage_tables[t][index[t]] = TAGE_ENTRY(taken ? 4 : 3, 0, tag[t]);
+                allocated = 1;
+            }
+            for(int t = provider + 1; t < TAGE_TABLES && !allocated; t++){
+                uint16_t entry = tage_tables[t][index[t]];
+                tage_tables[t][index[t]] = TAGE_ENTRY(TAGE_CTR(entry), TAGE_USEFUL(entry) - 1, TAGE_TAG(entry));
+            }
+        }
+        // Useful bits are halved now and then so stale entries can be replaced
+        if(++tage_updates % (1 << 18) == 0){
+            for(int t = 0; t < TAGE_TABLES; t++){
+                for(int i = 0; i < (1 << (table_bits - 2)); i++){
+                    uint16_t entry = tage_tables[t][i];
+                    tage_tables[t][i] = TAGE_ENTRY(TAGE_CTR(entry), TAGE_USEFUL(entry) >> 1, TAGE_TAG(entry));
+                }
+            }
+        }
+    }
+    return prediction;
+}
+
+// Function to look up the BTB and install the actual target, returns 1 if the stored target was right
+int btb_lookup(unsigned pc, unsigned target){
+    btb_entry* entry = &btb[(pc >> 2) % BTB_ENTRIES];
+    int hit = entry->pc == pc && entry->target == target;
+    entry->pc = pc;
+    entry->target = target;
+    if(!hit) bp_stats.btb_misses++;
+    return hit;
+}
+
+// Function to run one executed instruction through the predictors, returns 1 if the fetch was redirected late
+int predict_branch(retired_instr* retired){
+    unsigned instruction = retired->instruction;
+    unsigned opcode = instruction & 0x7f;
+    unsigned rd = (instruction >> 7) & 0x1f;
+    unsigned rs1 = (instruction >> 15) & 0x1f;
+    unsigned pc_now = retired->pc;
+    unsigned fall_through = pc_now + 4;
+    int taken = retired->next_pc != fall_through;
+    int mispredicted = 0;
+
+    if(opcode == 0x63){
+        // The branch target is only known for sure when the branch was taken
+        int imm = (((instruction >> 31) & 1) << 12) | (((instruction >> 7) & 1) << 11) |
+                  (((instruction >> 25) & 0x3f) << 5) | (((instruction >> 8) & 0xf) << 1);
+        if(imm & 0x1000) imm |= ~0x1fff;
+        int prediction = predict_direction(pc_now, pc_now + imm, taken);
+        mispredicted = prediction != taken;
+        if(taken && predictor != PREDICT_STATIC){
+            int target_hit = btb_lookup(pc_now, retired->next_pc);
+            if(!mispredicted) mispredicted = !target_hit;
+        }
+        global_history = (global_history << 1) | taken;
+        bp_stats.branches++;
+        bp_stats.branch_mispredicts += mispredicted;
+    }
+    else if(opcode == 0x6f || opcode == 0x67){
+        // Returns pop the RAS, calls (rd = ra) push it, anything else goes through the BTB
+        if(opcode == 0x67 && rd == 0 && rs1 == 1){
+            mispredicted = ras_top == 0 || ras[(ras_top - 1) % RAS_ENTRIES] != retired->next_pc;
+            if(ras_top > 0) ras_top--;
+            bp_stats.ras_mispredicts += mispredicted;
+        }
+        else mispredicted = !btb_lookup(pc_now, retired->next_pc);
+        if(rd == 1) ras[ras_top++ % RAS_ENTRIES] = fall_through;
+        bp_stats.jumps++;
+        bp_stats.jump_mispredicts += mispredicted;
+    }
+    else return 0;
+
+    if(pc_now / 4 < MAX_INSTRS){
+        pc_executed[pc_now / 4]++;
+        pc_mispredicted[pc_now / 4] += mispredicted;
+    }
+    return mispredicted;
+}
+
+// Function to clear every predictor table and the statistics
+void branch_predictor_reset(){
+    int entries = 1 << table_bits;
+    if(bimodal_table) memset(bimodal_table, 0x55, entries / 4);     // Weakly not taken
+    if(gshare_table) memset(gshare_table, 0x55, entries / 4);
+    if(chooser_table) memset(chooser_table, 0x55, entries / 4);
+    for(int t = 0; t < TAGE_TABLES; t++){
+        if(tage_tables[t]) memset(tage_tables[t], 0, (entries / 4) * sizeof(uint16_t));
+    }
+    memset(btb, 0xff, sizeof(btb));
+    memset(pc_executed, 0, sizeof(pc_executed));
+    memset(pc_mispredicted, 0, sizeof(pc_mispredicted));
+    memset(&bp_stats, 0, sizeof(bp_stats));
+    global_history = 0;
+    tage_updates = 0;
+    ras_top = 0;
+}
+
+// Function to release the predictor tables
+void release_branch_tables(){
+    free(bimodal_table);
+    free(gshare_table);
+    free(chooser_table);
+    bimodal_table = gshare_table = chooser_table = NULL;
+    for(int t = 0; t < TAGE_TABLES; t++){
+        free(tage_tables[t]);
+        tage_tables[t] = NULL;
+    }
+}
+
+// Function to select a predictor and allocate its tables of 2^bits counters
+void enable_branch_predictor(const char* kind, int bits){
+    predictor_kind selected;
+    if(strcmp(kind, "static") == 0) selected = PREDICT_STATIC;
+    else if(strcmp(kind, "bimodal") == 0) selected = PREDICT_BIMODAL;
+    else if(strcmp(kind, "gshare") == 0) selected = PREDICT_GSHARE;
+    else if(strcmp(kind, "tournament") == 0) selected = PREDICT_TOURNAMENT;
+    else if(strcmp(kind, "tage") == 0) selected = PREDICT_TAGE;
+    else{
+        printf("Error: Unknown predictor %s (static, bimodal, gshare, tournament or tage)\n", kind);
+        return;
+    }
+    if(bits < 4 || bits > 24){
+        printf("Error: Table size must be between 2^4 and 2^24 entries\n");
+        return;
+    }
+
+    release_branch_tables();
+    predictor = selected;
+    table_bits = bits;
+    int bytes = (1 << bits) / 4;
+    if(predictor != PREDICT_STATIC) bimodal_table = malloc(bytes);
+    if(predictor == PREDICT_GSHARE || predictor == PREDICT_TOURNAMENT) gshare_table = malloc(bytes);
+    if(predictor == PREDICT_TOURNAMENT) chooser_table = malloc(bytes);
+    if(predictor == PREDICT_TAGE){
+        for(int t = 0; t < TAGE_TABLES; t++) tage_tables[t] = malloc((1 << (bits - 2)) * sizeof(uint16_t));
+    }
+    branch_predictor_reset();
+    branch_predictor_enabled = 1;
+    printf("Branch predictor enabled: %s with 2^%d entries, %d-entry BTB, %d-entry RAS\n", kind, bits, BTB_ENTRIES, RAS_ENTRIES);
+}
+
+// Function to switch the branch predictor off
+void disable_branch_predictor(){
+    release_branch_tables();
+    branch_predictor_enabled = 0;
+    printf("Branch predictor disabled\n");
+}
+
+// Function to print the aggregate mispredict rates and the branches that mispredict most
+void print_branch_stats(){
+    if(!branch_predictor_enabled){
+        printf("Branch predictor is disabled\n");
+        return;
+    }
+    long long total = bp_stats.branches + bp_stats.jumps;
+    long long mispredicts = bp_stats.branch_mispredicts + bp_stats.jump_mispredicts;
+    printf("Conditional branches: %lld, mispredicted: %lld (%.2f%%)\n", bp_stats.branches, bp_stats.branch_mispredicts,
+           bp_stats.branches ? 100.0 * bp_stats.branch_mispredicts / bp_stats.branches : 0.0);
+    printf("Jumps: %lld, mispredicted: %lld (%.2f%%), BTB misses: %lld, RAS mispredicts: %lld\n", bp_stats.jumps,
+           bp_stats.jump_mispredicts, bp_stats.jumps ? 100.0 * bp_stats.jump_mispredicts / bp_stats.jumps : 0.0,
+           bp_stats.btb_misses, bp_stats.ras_mispredicts);
+    printf("Overall mispredict rate: %.2f%%\n", total ? 100.0 * mispredicts / total : 0.0);
+
+    printf("Per-branch mispredicts:\n");
+    for(int i = 0; i < instr_count && i < MAX_INSTRS; i++){
+        if(pc_executed[i] == 0) continue;
+        printf("  0x%08x %-30s executed %u, mispredicted %u (%.2f%%)\n", i * 4, instructions[i],
+               pc_executed[i], pc_mispredicted[i], 100.0 * pc_mispredicted[i] / pc_executed[i]);
+    }
+}
\ No newline at end of file
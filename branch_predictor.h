@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <stdint.h>
+
+#ifndef BRANCH_PREDICTOR_H
+#define BRANCH_PREDICTOR_H
+
+#include "simulator.h"
+
+#define BTB_ENTRIES 512
+#define RAS_ENTRIES 16
+#define TAGE_TABLES 4
+
+typedef enum{
+    PREDICT_STATIC,         // Backward taken, forward not taken
+    PREDICT_BIMODAL,
+    PREDICT_GSHARE,
+    PREDICT_TOURNAMENT,     // Bimodal and gshare with a per-branch chooser
+    PREDICT_TAGE            // Bimodal base with tagged tables of growing history length
+} predictor_kind;
+
+typedef struct{
+    unsigned pc;
+    unsigned target;
+} btb_entry;
+
+typedef struct{
+    long long branches;             // Conditional branches
+    long long branch_mispredicts;   // Wrong direction or, for taken branches, wrong target
+    long long jumps;                // jal and jalr
+    long long jump_mispredicts;
+    long long btb_misses;
+    long long ras_mispredicts;
+} branch_stats;
+
+extern int branch_predictor_enabled;
+extern branch_stats bp_stats;
+
+void enable_branch_predictor(const char* kind, int table_bits);
+void disable_branch_predictor();
+void branch_predictor_reset();
+int predict_branch(retired_instr* retired);
+void print_branch_stats();
+
+#endif
\ No newline at end of file
@@ -1,5 +1,12 @@
 #include "assembler.h"
 #include "cache.h"
+#include "simulator.h"
+#include "prefetcher.h"
+#include "cache_buffers.h"
+#include "miss_classifier.h"
+#include "heatmap.h"
+#include "dram.h"
+#include "vm.h"
 
 int cache_size, block_size, associativity;
 char replacement_policy[8];
@@ -8,8 +15,56 @@ char write_back_policy[8];
 int cache_enabled = 0;
 
 Cache* cache;
+replacement_kind replacement = REPLACE_LRU;
+int dip_psel = PSEL_MAX / 2;    // Saturating DIP selector, above the midpoint the followers insert bimodally
+long long bimodal_fills = 0;
+
+long long cache_accesses = 0;
+long long cache_hits = 0;
+long long cache_misses = 0;
+long long cache_clock = 0;      // Access counter the LRU, FIFO and LFU timestamps come from
+long long cache_allocations = 0;   // Host event counters, kept across loads
+long long cache_writebacks = 0;
+unsigned cache_access_pc = 0;  // PC of the load or store being looked up, set by the caller for the prefetchers
+int probing_tags = 0;           // 1 inside cache_probe(), prefetches then move tags only
+
+// Function to release the lines and sets of the current cache, if any
+void release_cache(){
+    if(cache == NULL) return;
+    for(int i = 0; i < cache->num_sets; i++){
+        for(int j = 0; j < cache->lines_per_set; j++) free(cache->sets[i].lines[j].block);
+        free(cache->sets[i].lines);
+    }
+    free(cache->sets);
+    free(cache);
+    cache = NULL;
+}
+
+// Function to map the configured policy name, returns 0 for an unknown name and -1 if the associativity does not fit it
+int parse_replacement_policy(){
+    const char* names[] = {"LRU", "FIFO", "LFU", "RANDOM", "PLRU", "SRRIP", "BRRIP", "DIP"};
+    for(int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++){
+        if(strcmp(replacement_policy, names[i]) != 0) continue;
+        replacement = (replacement_kind)i;
+        // The tree needs a power of two ways in 63 bits, the RRPVs two bits per way in 64 bits
+        if((replacement == REPLACE_PLRU || replacement == REPLACE_DIP) && (associativity > 64 || (associativity & (associativity - 1)))) return -1;
+        if((replacement == REPLACE_SRRIP || replacement == REPLACE_BRRIP) && associativity > 32) return -1;
+        return 1;
+    }
+    return 0;
+}
 
 void initialize_cache(){
+    release_cache();    // Re-enabling or restoring a checkpoint replaces the old cache
+    int parsed = parse_replacement_policy();
+    if(parsed != 1){
+        if(parsed == 0) printf("Error: Unknown replacement policy %s, using LRU\n", replacement_policy);
+        else printf("Error: Replacement policy %s does not support %d ways, using LRU\n", replacement_policy, associativity);
+        strcpy(replacement_policy, "LRU");
+        replacement = REPLACE_LRU;
+    }
+    dip_psel = PSEL_MAX / 2;
+    bimodal_fills = 0;
     int num_sets = cache_size / (block_size * associativity);
     cache = (Cache*)malloc(sizeof(Cache));
     cache->num_sets = num_sets;
@@ -18,6 +73,8 @@ void initialize_cache(){
 
     for(int i = 0; i < num_sets; i++){
         cache->sets[i].lines = (CacheLine*)malloc(associativity * sizeof(CacheLine));
+        cache->sets[i].policy_bits = 0;
+        cache->sets[i].filled = 0;
         for(int j = 0;j<associativity;j++){
             cache->sets[i].lines[j].valid = 0;
             cache->sets[i].lines[j].dirty = 0;
@@ -25,8 +82,15 @@ void initialize_cache(){
             cache->sets[i].lines[j].block = (char*)malloc(block_size);
             cache->sets[i].lines[j].last_access_time = 0;  // Initialize for LRU policy
             cache->sets[i].lines[j].load_time = 0;         // Initialize for FIFO policy
+            cache->sets[i].lines[j].frequency = 0;         // Initialize for LFU policy
+            cache->sets[i].lines[j].prefetched = 0;
+            cache->sets[i].lines[j].ready_time = 0;
         }
     }
+    victim_cache_clear();   // Blocks held for the old cache do not belong to the new one
+    write_buffer_clear();
+    miss_classifier_reset();
+    heatmap_reset();
 }
 
 void enable_cache(char* config_file){
@@ -91,9 +155,480 @@ void print_cache_status(){
     else printf("Cache Status: Disabled\n");    
 }
 
-void calculate_cache_address(unsigned address, int* tag, int* set_index){
+void calculate_cache_address(unsigned address, unsigned* tag, int* set_index){
     int block_offset_bits = __builtin_ctz(block_size);  // Identifying the required number of bits to address all spots in the block
     int set_index_bits = __builtin_ctz(cache->num_sets);    // Similar to above
-    *tag = (int)(address >> (set_index_bits + block_offset_bits));  // Calculating tag and set_index values
+    *tag = address >> (set_index_bits + block_offset_bits);  // Calculating tag and set_index values
     *set_index = (int)((address >> block_offset_bits) & (cache->num_sets - 1));
+}
+
+// Function to point every tree node on the path to a way away from it, making it the most recently used
+void plru_touch(CacheSet* set, int way){
+    int node = cache->lines_per_set - 1 + way;
+    while(node > 0){
+        int parent = (node - 1) / 2;
+        if(node == 2 * parent + 1) set->policy_bits |= 1ULL << parent;     // Left child, victims go right
+        else set->policy_bits &= ~(1ULL << parent);
+        node = parent;
+    }
+}
+
+// Function to follow the tree bits to the pseudo least recently used way
+int plru_victim(CacheSet* set){
+    int node = 0;
+    while(node < cache->lines_per_set - 1) node = 2 * node + 1 + (int)((set->policy_bits >> node) & 1);
+    return node - (cache->lines_per_set - 1);
+}
+
+// Function to set the 2-bit re-reference prediction value of a way
+void set_rrpv(CacheSet* set, int way, unsigned long long value){
+    set->policy_bits = (set->policy_bits & ~(3ULL << (2 * way))) | (value << (2 * way));
+}
+
+// Function to find a way predicted to be re-referenced in the distant future, ageing the set if there is none
+int rrip_victim(CacheSet* set){
+    int ways = cache->lines_per_set;
+    unsigned long long lanes = 0x5555555555555555ULL >> (64 - 2 * ways);    // Low bit of every way's RRPV
+    unsigned long long bits = set->policy_bits;
+    unsigned long long distant = bits & (bits >> 1) & lanes;
+    if(!distant){
+        // Every RRPV goes up by the same amount, so the largest reaches 3 and nothing overflows
+        int age = ((bits >> 1) & lanes) ? 1 : (bits & lanes) ? 2 : 3;
+        bits += age * lanes;
+        set->policy_bits = bits;
+        distant = bits & (bits >> 1) & lanes;
+    }
+    return __builtin_ctzll(distant) / 2;
+}
+
+// Function to tell whether a DIP set inserts bimodally, leader sets are fixed and followers go by PSEL
+int dip_bimodal(int set_index){
+    int spacing = cache->num_sets >= 2 * DIP_LEADERS ? cache->num_sets / DIP_LEADERS : 2;
+    if(set_index % spacing == 0) return 0;  // LRU leader
+    if(set_index % spacing == 1) return 1;  // BIP leader
+    return dip_psel > PSEL_MAX / 2;
+}
+
+// Function to train the DIP selector on a demand miss in a leader set
+void replacement_miss(int set_index){
+    if(replacement != REPLACE_DIP) return;
+    int spacing = cache->num_sets >= 2 * DIP_LEADERS ? cache->num_sets / DIP_LEADERS : 2;
+    if(set_index % spacing == 0 && dip_psel < PSEL_MAX) dip_psel++;     // LRU is missing, lean towards BIP
+    else if(set_index % spacing == 1 && dip_psel > 0) dip_psel--;
+}
+
+CacheLine* select_eviction_line(CacheSet* set){
+    // Choosing a random victim if the policy is random
+    if(replacement == REPLACE_RANDOM){
+        int random_index = rand() % cache->lines_per_set;
+        return &set->lines[random_index];
+    }
+    // Sets fill from way 0 up and lines are never invalidated, so the empty lines come after set->filled
+    while(set->filled < cache->lines_per_set && set->lines[set->filled].valid) set->filled++;
+    if(set->filled < cache->lines_per_set) return &set->lines[set->filled];   // Pick an empty line if we can
+
+    if(replacement == REPLACE_PLRU || replacement == REPLACE_DIP) return &set->lines[plru_victim(set)];
+    if(replacement == REPLACE_SRRIP || replacement == REPLACE_BRRIP) return &set->lines[rrip_victim(set)];
+
+    CacheLine* eviction_line = NULL;
+    long long oldest_load_time = LLONG_MAX;
+    long long oldest_access_time = LLONG_MAX;
+    int min_frequency = INT_MAX;
+    for(int i = 0; i < cache->lines_per_set; i++){
+        CacheLine* line = &set->lines[i];
+        if(replacement == REPLACE_LRU){
+            if(line->last_access_time < oldest_access_time){
+                oldest_access_time = line->last_access_time;
+                eviction_line = line;
+            }
+        }
+        else if(replacement == REPLACE_FIFO){
+            if(line->load_time < oldest_load_time){
+                oldest_load_time = line->load_time;
+                eviction_line = line;
+            }
+        }
+        else if(line->frequency < min_frequency ||
+                (line->frequency == min_frequency && line->last_access_time < oldest_access_time)){
+            min_frequency = line->frequency;
+            oldest_access_time = line->last_access_time;
+            eviction_line = line;
+        }
+    }
+    return eviction_line;
+}
+
+// Function to copy one block of memory, page table blocks come from the page table memory above data memory
+void read_memory_block(char* block, unsigned block_start){
+    if(block_start >= PAGE_TABLE_BASE){
+        memcpy(block, page_table_memory + block_start - PAGE_TABLE_BASE, block_size);
+        return;
+    }
+    for(int i = 0; i < block_size; i++){
+        block[i] = data_section[block_start + i - DATA_START];    // Memory holds one byte per element
+    }
+}
+
+// Used to load one block of memory into chosen cache line
+void load_block_from_memory(CacheLine* line, unsigned address){
+    read_memory_block(line->block, address - (address % block_size));
+}
+
+// Function to rebuild the address of the block a line holds
+unsigned line_address(CacheLine* line, int set_index){
+    return (line->tag << (__builtin_ctz(block_size) + __builtin_ctz(cache->num_sets))) | (set_index << __builtin_ctz(block_size));
+}
+
+// Function to write a whole block back to memory
+void write_block_to_memory(CacheLine* line, int set_index){
+    cache_writebacks++;
+    unsigned block_start = line_address(line, set_index);
+    if(dram_enabled) dram_post(block_start, 1);
+    for(int i = 0; i < block_size; i++){
+        data_section[block_start + i - DATA_START] = (unsigned char)line->block[i];
+    }
+}
+
+// Function to update cache line access times
+void update_access_time(CacheLine* line){
+    line->last_access_time = cache_clock;
+    line->frequency++;
+    cache_clock++;
+}
+
+// Function to update the replacement state of a line hit by a demand access
+void touch_line(CacheSet* set, CacheLine* line){
+    update_access_time(line);
+    int way = line - set->lines;
+    if(replacement == REPLACE_PLRU || replacement == REPLACE_DIP) plru_touch(set, way);
+    else if(replacement == REPLACE_SRRIP || replacement == REPLACE_BRRIP) set_rrpv(set, way, 0);
+}
+
+// Function to place a newly filled line in the replacement order
+void insert_line(int set_index, CacheLine* line){
+    CacheSet* set = &cache->sets[set_index];
+    int way = line - set->lines;
+    // The bimodal policies insert as if never reused, except for one fill in BIMODAL_PERIOD
+    int bimodal = replacement == REPLACE_BRRIP || (replacement == REPLACE_DIP && dip_bimodal(set_index));
+    int keep = !bimodal || ++bimodal_fills % BIMODAL_PERIOD == 0;
+    if(replacement == REPLACE_PLRU || replacement == REPLACE_DIP){
+        if(keep) plru_touch(set, way);     // Otherwise the tree keeps pointing at the new line
+    }
+    else if(replacement == REPLACE_SRRIP || replacement == REPLACE_BRRIP) set_rrpv(set, way, keep ? 2 : 3);
+}
+
+// Function to find the line holding a tag in a set, NULL on a miss
+CacheLine* find_line(CacheSet* set, unsigned tag){
+    for(int i = 0; i < cache->lines_per_set; i++){
+        if(set->lines[i].valid && set->lines[i].tag == tag) return &set->lines[i];
+    }
+    return NULL;
+}
+
+// Function to fill a line with the block holding an address, writing back the victim if needed
+// Without move_data only the tags and replacement state change, the victim's write-back is just counted
+void fill_line(CacheLine* line, unsigned address, unsigned tag, int set_index, int move_data){
+    cache_allocations++;
+    if(line->valid && line->prefetched) pf_stats.unused++;
+    if(line->valid && heatmap_enabled) heat_eviction(line_address(line, set_index), set_index);
+    if(line->valid && victim_cache_enabled){
+        // The victim cache takes over the line, a dirty block is written back only when it leaves there
+        victim_insert(line_address(line, set_index), line->block, line->dirty && strcmp(write_back_policy, "WB") == 0, move_data);
+    }
+    else if(line->valid && line->dirty && strcmp(write_back_policy, "WB") == 0){
+        if(move_data) write_block_to_memory(line, set_index);
+        else{
+            cache_writebacks++;
+            if(dram_enabled) dram_post(line_address(line, set_index), 1);
+        }
+    }
+
+    if(move_data) load_block_from_memory(line, address);
+    line->tag = tag;
+    line->valid = 1;
+    line->dirty = 0;
+    line->frequency = 0;
+    line->prefetched = 0;
+    line->load_time = cache_clock;  // For FIFO policy
+    update_access_time(line);
+    insert_line(set_index, line);
+}
+
+// Function to bring the block holding an address into the cache on a demand miss
+// A block found in the victim cache is swapped back in and counts as a hit
+CacheLine* allocate_line(unsigned address, unsigned tag, int set_index, int move_data){
+    unsigned block_start = address - address % block_size;
+    int dirty = 0;
+    char* rescued = victim_cache_enabled ? victim_take(block_start, &dirty, move_data) : NULL;
+    if(rescued) cache_hits++;
+    else{
+        cache_misses++;
+        if(prefetcher_enabled) prefetch_check_pollution(block_start);
+    }
+    if(miss_classifier_enabled) classify_access(block_start, set_index, !rescued);
+    if(heatmap_enabled) heat_access(block_start, set_index, !rescued);
+    if(dram_enabled && !rescued) dram_stall_cycles += dram_read(block_start);
+    replacement_miss(set_index);
+    CacheLine* line = select_eviction_line(&cache->sets[set_index]);
+    fill_line(line, address, tag, set_index, move_data);
+    if(rescued){
+        if(move_data) memcpy(line->block, rescued, block_size);
+        line->dirty = dirty;
+    }
+    return line;
+}
+
+// Function to count a demand hit, a prefetched block that has not arrived yet still costs a miss
+// With the DRAM model the fill's arrival cycle decides, and the access waits for the rest of it
+// Returns 1 if the hit should trigger more prefetches
+int demand_hit(CacheSet* set, CacheLine* line){
+    int first_use = line->prefetched, late;
+    if(dram_enabled && first_use){
+        long long wait = dram_fill_wait(line_address(line, set - cache->sets));
+        late = wait > 0;
+        dram_stall_cycles += wait;
+    }
+    else late = first_use && cache_clock < line->ready_time;
+    if(miss_classifier_enabled) classify_access(line_address(line, set - cache->sets), set - cache->sets, 0);
+    if(heatmap_enabled) heat_access(line_address(line, set - cache->sets), set - cache->sets, late);
+    touch_line(set, line);
+    if(late){
+        cache_misses++;
+        pf_stats.late++;
+    }
+    else cache_hits++;
+    if(first_use){
+        pf_stats.useful++;
+        line->prefetched = 0;
+    }
+    return first_use;
+}
+
+// Function to bring a block in ahead of demand, blocks already cached or outside data memory are skipped
+void prefetch_block(unsigned address){
+    unsigned block_start = address - address % block_size;
+    if(block_start < DATA_START || block_start + block_size > STACK_START) return;
+    unsigned tag;
+    int set_index;
+    calculate_cache_address(block_start, &tag, &set_index);
+    CacheSet* set = &cache->sets[set_index];
+    if(find_line(set, tag)) return;
+    if(victim_cache_enabled && victim_holds(block_start)) return;
+
+    CacheLine* line = select_eviction_line(set);
+    if(line->valid) prefetch_note_victim(line_address(line, set_index));
+    if(dram_enabled) dram_post(block_start, 0);
+    fill_line(line, block_start, tag, set_index, !probing_tags);
+    line->prefetched = 1;
+    line->ready_time = cache_clock + prefetch_settings.latency;
+    pf_stats.issued++;
+}
+
+// Function to directly write data into memory
+void write_data_to_memory(unsigned address, long long data, int funct3){
+    int bytes_to_write = 1 << (funct3 & 0x3);   // sb, sh, sw, sd
+    for(int i = 0; i < bytes_to_write; i++){
+        data_section[address + i - DATA_START] = (data >> (8 * i)) & 0xff;
+    }
+}
+
+// Function to write into a chosen cache line, stopping at the end of the block
+int write_data_to_cache_line(CacheLine* line, unsigned address, long long data, int bytes_to_write){
+    int offset = address % block_size;
+    int bytes_this_write = (offset + bytes_to_write > block_size) ? block_size - offset : bytes_to_write;
+    for(int i = 0; i < bytes_this_write; i++){
+        line->block[offset + i] = (data >> (8 * i)) & 0xff;
+    }
+    if(strcmp(write_back_policy, "WB") == 0) line->dirty = 1;
+    return bytes_this_write;
+}
+
+// Function to handle misses while writing into cache (write allocate)
+CacheLine* handle_write_miss(unsigned address){
+    unsigned tag;
+    int set_index;
+    calculate_cache_address(address, &tag, &set_index);
+    return allocate_line(address, tag, set_index, 1);
+}
+
+// Method to write into cache, an access that straddles two blocks looks up both
+void cache_write(unsigned address, long long data, int funct3){
+    int bytes_to_write = 1 << (funct3 & 0x3);
+    if(write_buffer_enabled){
+        write_buffer_store(address, data, bytes_to_write, 1);   // Reaches the cache when the entry drains
+        return;
+    }
+    int bytes_written = 0, trigger = 0;
+    while(bytes_written < bytes_to_write){
+        unsigned current_address = address + bytes_written;
+        unsigned tag;
+        int set_index;
+        calculate_cache_address(current_address, &tag, &set_index);
+        cache_accesses++;
+
+        CacheLine* line = find_line(&cache->sets[set_index], tag);
+        if(line) trigger |= demand_hit(&cache->sets[set_index], line);
+        else{
+            line = handle_write_miss(current_address);
+            trigger = 1;
+        }
+
+        bytes_written += write_data_to_cache_line(line, current_address, data >> (8 * bytes_written), bytes_to_write - bytes_written);
+    }
+    if(strcmp(write_back_policy, "WT") == 0){
+        write_data_to_memory(address, data, funct3);
+        if(dram_enabled) dram_post(address, 1);
+    }
+    if(prefetcher_enabled) prefetch_access(cache_access_pc, address, trigger);
+}
+
+int cache_read(unsigned address, int funct3, long long* read_data){
+    int bytes_to_read = 1 << (funct3 & 0x3);
+    if(write_buffer_enabled) write_buffer_load(address, bytes_to_read, 1);
+    unsigned long long value = 0;
+
+    int bytes_read = 0, trigger = 0;
+    while(bytes_read < bytes_to_read){
+        unsigned current_address = address + bytes_read;
+        unsigned tag;
+        int set_index;
+        calculate_cache_address(current_address, &tag, &set_index);
+        cache_accesses++;
+
+        CacheLine* target_line = find_line(&cache->sets[set_index], tag);
+        if(target_line == NULL){
+            target_line = allocate_line(current_address, tag, set_index, 1);
+            trigger = 1;
+        }
+        else trigger |= demand_hit(&cache->sets[set_index], target_line);
+
+        int offset = current_address % block_size;
+        while(offset < block_size && bytes_read < bytes_to_read){
+            value |= (unsigned long long)(unsigned char)target_line->block[offset++] << (8 * bytes_read);
+            bytes_read++;
+        }
+    }
+
+    // Sign extension for lb, lh, lw and zero extension for lbu, lhu, lwu
+    int shift = 64 - 8 * bytes_to_read;
+    if(funct3 & 0x4) *read_data = (long long)value;
+    else *read_data = (long long)(value << shift) >> shift;
+    if(prefetcher_enabled) prefetch_access(cache_access_pc, address, trigger);
+    return 0;
+}
+
+// Function to run an access through the tags alone, hits and misses match cache_read() and cache_write()
+void cache_probe(unsigned address, int bytes, int is_write){
+    if(write_buffer_enabled){
+        if(is_write){
+            write_buffer_store(address, 0, bytes, 0);
+            return;
+        }
+        write_buffer_load(address, bytes, 0);
+    }
+    int bytes_done = 0, trigger = 0;
+    while(bytes_done < bytes){
+        unsigned current_address = address + bytes_done;
+        unsigned tag;
+        int set_index;
+        calculate_cache_address(current_address, &tag, &set_index);
+        cache_accesses++;
+
+        CacheLine* line = find_line(&cache->sets[set_index], tag);
+        if(line) trigger |= demand_hit(&cache->sets[set_index], line);
+        else{
+            line = allocate_line(current_address, tag, set_index, 0);
+            trigger = 1;
+        }
+        if(is_write && strcmp(write_back_policy, "WB") == 0) line->dirty = 1;
+        if(is_write && dram_enabled && strcmp(write_back_policy, "WT") == 0) dram_post(current_address, 1);
+        int offset = current_address % block_size;
+        bytes_done += (offset + bytes - bytes_done > block_size) ? block_size - offset : bytes - bytes_done;
+    }
+    if(prefetcher_enabled){
+        probing_tags = 1;
+        prefetch_access(cache_access_pc, address, trigger);
+        probing_tags = 0;
+    }
+}
+
+// Function to run a page table read through the cache, the walker takes the PTE itself from the page tables
+// The access moves data only with move_data, as cache_probe() it does not train the prefetcher
+void cache_walk_read(unsigned address, int move_data){
+    unsigned tag;
+    int set_index;
+    calculate_cache_address(address, &tag, &set_index);
+    cache_accesses++;
+    CacheLine* line = find_line(&cache->sets[set_index], tag);
+    if(line) demand_hit(&cache->sets[set_index], line);
+    else allocate_line(address, tag, set_index, move_data);
+}
+
+// Function to write one drained write buffer entry into the cache with a single lookup
+void cache_write_masked(unsigned base, const char* bytes, unsigned long long mask, int move_data){
+    unsigned tag;
+    int set_index;
+    calculate_cache_address(base, &tag, &set_index);
+    cache_accesses++;
+    CacheLine* line = find_line(&cache->sets[set_index], tag);
+    if(line) demand_hit(&cache->sets[set_index], line);
+    else line = allocate_line(base, tag, set_index, move_data);
+
+    int offset = base % block_size;
+    for(int i = 0; i < WRITE_BUFFER_CHUNK; i++){
+        if(!(mask >> i & 1) || !move_data) continue;
+        line->block[offset + i] = bytes[i];
+        if(strcmp(write_back_policy, "WT") == 0) data_section[base + i - DATA_START] = (unsigned char)bytes[i];
+    }
+    if(strcmp(write_back_policy, "WB") == 0) line->dirty = 1;
+    else if(dram_enabled) dram_post(base, 1);
+}
+
+// Function to write every dirty line back so memory holds the current data
+void flush_cache(){
+    if(cache == NULL) return;
+    if(write_buffer_enabled) write_buffer_drain_all(1);
+    if(victim_cache_enabled) victim_flush();
+    for(int i = 0; i < cache->num_sets; i++){
+        for(int j = 0; j < cache->lines_per_set; j++){
+            CacheLine* line = &cache->sets[i].lines[j];
+            if(line->valid && line->dirty) write_block_to_memory(line, i);
+            line->dirty = 0;
+        }
+    }
+}
+
+// Function to copy the data of every dirty line and pending store into memory, the cache state is left as it is
+void publish_cache_to_memory(){
+    /*
+    Unlike flush_cache() nothing is written back or cleaned, so the models see the same cache as before
+    and only memory catches up, which is what running the interpreter straight on memory needs
+    */
+    if(cache == NULL) return;
+    for(int i = 0; i < cache->num_sets; i++){
+        for(int j = 0; j < cache->lines_per_set; j++){
+            CacheLine* line = &cache->sets[i].lines[j];
+            if(!line->valid || !line->dirty) continue;
+            unsigned block_start = line_address(line, i);
+            for(int k = 0; k < block_size; k++) data_section[block_start + k - DATA_START] = (unsigned char)line->block[k];
+        }
+    }
+    cache_buffers_publish_to_memory();   // Buffered stores are newer than the lines they will be merged into
+}
+
+// Function to reload the data of every valid line after memory was changed behind the cache
+void sync_cache_from_memory(){
+    /*
+    Tags and replacement state are kept, so a cache that was warmed earlier stays warm,
+    only the block contents are refreshed
+    */
+    if(cache == NULL) return;
+    for(int i = 0; i < cache->num_sets; i++){
+        for(int j = 0; j < cache->lines_per_set; j++){
+            CacheLine* line = &cache->sets[i].lines[j];
+            if(!line->valid) continue;
+            load_block_from_memory(line, line_address(line, i));
+        }
+    }
+    cache_buffers_sync_from_memory();
 }
\ No newline at end of file
@@ -14,13 +14,17 @@ typedef struct {
     int dirty;              // For write-back policy
     unsigned tag;
     char* block;            // Pointer to data block
-    int last_access_time;   // For LRU policy
-    int load_time;          // For FIFO policy
+    long long last_access_time;     // For LRU policy
+    long long load_time;            // For FIFO policy
     int frequency;          // For LFU policy
+    int prefetched;         // Filled by a prefetch and not yet touched by a demand access
+    long long ready_time;   // Cache clock at which a prefetched block arrives
 } CacheLine;
 
 typedef struct{
     CacheLine* lines;        // Array of cache lines for set-associativity
+    unsigned long long policy_bits;     // Tree bits for PLRU and DIP, 2-bit RRPVs per way for SRRIP and BRRIP
+    int filled;              // Ways in use, a set fills from way 0 up
 } CacheSet;
 
 typedef struct{
@@ -29,15 +33,47 @@ typedef struct{
     CacheSet* sets;          // Array of cache sets
 } Cache;
 
+typedef enum{
+    REPLACE_LRU,
+    REPLACE_FIFO,
+    REPLACE_LFU,
+    REPLACE_RANDOM,
+    REPLACE_PLRU,           // Tree pseudo-LRU
+    REPLACE_SRRIP,          // Static re-reference interval prediction
+    REPLACE_BRRIP,          // Bimodal RRIP, mostly inserts as distant
+    REPLACE_DIP             // Set dueling between LRU and bimodal insertion on the PLRU tree
+} replacement_kind;
+
+#define DIP_LEADERS 32      // Leader sets per DIP policy
+#define PSEL_MAX 1023       // 10-bit DIP selector
+#define BIMODAL_PERIOD 32   // Bimodal insertion keeps one fill in this many
+
 extern int cache_enabled;
 extern Cache* cache;
 extern int cache_size, block_size, associativity;
 extern char replacement_policy[8];
+extern replacement_kind replacement;
+extern int dip_psel;
 extern char write_back_policy[8];
+extern long long cache_accesses, cache_hits, cache_misses, cache_clock;
+extern long long cache_allocations, cache_writebacks;
+extern unsigned cache_access_pc;
 
+void initialize_cache();
 void enable_cache(char* config_file);
 void disable_cache();
 void print_cache_status();
-void calculate_cache_address(unsigned address, int* tag, int* set_index);
+int cache_read(unsigned address, int funct3, long long* read_data);
+void cache_write(unsigned address, long long data, int funct3);
+void cache_probe(unsigned address, int bytes, int is_write);
+void cache_walk_read(unsigned address, int move_data);
+void read_memory_block(char* block, unsigned block_start);
+void prefetch_block(unsigned address);
+void cache_write_masked(unsigned base, const char* bytes, unsigned long long mask, int move_data);
+void write_data_to_memory(unsigned address, long long data, int funct3);
+void flush_cache();
+void sync_cache_from_memory();
+void publish_cache_to_memory();
+void calculate_cache_address(unsigned address, unsigned* tag, int* set_index);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "cache_buffers.h"
+#include "dram.h"
+
+/*
+Two small fully associative structures next to the cache, both replaced in LRU order
+The victim cache catches every valid line the cache evicts, a demand miss that finds its block there
+swaps it back in and counts as a hit, dirty lines reach memory only when the victim cache pushes them out
+The write buffer holds stores per aligned chunk with a byte mask so a burst of stores to one chunk costs
+one cache write, entries drain when full, when evicted for a new chunk, and before a load that overlaps them
+*/
+int victim_cache_enabled = 0, write_buffer_enabled = 0;
+victim_stats vc_stats;
+write_buffer_stats wb_stats;
+
+victim_entry victims[MAX_VICTIM_ENTRIES];
+int victim_entries = 0;
+int victim_block_size = 0;     // Block size the entries were allocated for
+char* victim_scratch = NULL;    // Holds a block taken out of the victim cache until its line is chosen
+long long victim_clock = 0;
+
+write_buffer_entry write_buffer[MAX_WRITE_BUFFER_ENTRIES];
+int write_buffer_entries = 0;
+long long write_buffer_clock = 0;
+
+// Function to return the bytes one write buffer entry covers
+int write_buffer_chunk(){
+    return block_size < WRITE_BUFFER_CHUNK ? block_size : WRITE_BUFFER_CHUNK;
+}
+
+// Function to empty the victim cache, reallocating the blocks if the cache block size changed
+void victim_cache_clear(){
+    if(victim_block_size != block_size){
+        for(int i = 0; i < MAX_VICTIM_ENTRIES; i++){
+            free(victims[i].block);
+            victims[i].block = malloc(block_size);
+        }
+        free(victim_scratch);
+        victim_scratch = malloc(block_size);
+        victim_block_size = block_size;
+    }
+    for(int i = 0; i < MAX_VICTIM_ENTRIES; i++){
+        victims[i].valid = 0;
+        victims[i].dirty = 0;
+    }
+}
+
+// Function to drop every pending store, used when the memory image is replaced
+void write_buffer_clear(){
+    for(int i = 0; i < MAX_WRITE_BUFFER_ENTRIES; i++) write_buffer[i].valid = 0;
+}
+
+// Function to write a victim cache entry back to memory
+void victim_write_back(victim_entry* entry, int move_data){
+    vc_stats.writebacks++;
+    cache_writebacks++;
+    if(dram_enabled) dram_post(entry->block_address, 1);
+    if(move_data){
+        for(int i = 0; i < block_size; i++) data_section[entry->block_address + i - DATA_START] = (unsigned char)entry->block[i];
+    }
+    entry->dirty = 0;
+}
+
+// Function to catch a line evicted from the cache, the least recently used entry makes room
+void victim_insert(unsigned block_address, const char* block, int dirty, int move_data){
+    victim_entry* slot = &victims[0];
+    for(int i = 0; i < victim_entries; i++){
+        if(!victims[i].valid){
+            slot = &victims[i];
+            break;
+        }
+        if(victims[i].last_use < slot->last_use) slot = &victims[i];
+    }
+    if(slot->valid && slot->dirty) victim_write_back(slot, move_data);
+
+    vc_stats.insertions++;
+    slot->valid = 1;
+    slot->dirty = dirty;
+    slot->block_address = block_address;
+    slot->last_use = victim_clock++;
+    if(move_data) memcpy(slot->block, block, block_size);
+}
+
+// Function to check whether a block is in the victim cache without touching it
+int victim_holds(unsigned block_address){
+    for(int i = 0; i < victim_entries; i++){
+        if(victims[i].valid && victims[i].block_address == block_address) return 1;
+    }
+    return 0;
+}
+
+// Function to search the victim cache on a cache miss, a hit removes the entry and returns its data
+// The data stays valid until the next victim_take(), NULL on a miss
+char* victim_take(unsigned block_address, int* dirty, int move_data){
+    vc_stats.lookups++;
+    for(int i = 0; i < victim_entries; i++){
+        if(!victims[i].valid || victims[i].block_address != block_address) continue;
+        vc_stats.hits++;
+        victims[i].valid = 0;
+        *dirty = victims[i].dirty;
+        if(move_data) memcpy(victim_scratch, victims[i].block, block_size);
+        return victim_scratch;
+    }
+    return NULL;
+}
+
+// Function to write every dirty victim cache entry back so memory holds the current data
+void victim_flush(){
+    for(int i = 0; i < victim_entries; i++){
+        if(victims[i].valid && victims[i].dirty) victim_write_back(&victims[i], 1);
+    }
+}
+
+// Function to write one pending entry into the cache
+void write_buffer_drain(write_buffer_entry* entry, int move_data){
+    wb_stats.drains++;
+    entry->valid = 0;
+    cache_write_masked(entry->base, entry->bytes, entry->mask, move_data);
+}
+
+// Function to put a store in the buffer, stores crossing a chunk boundary take an entry per chunk
+void write_buffer_store(unsigned address, long long data, int bytes, int move_data){
+    int chunk = write_buffer_chunk();
+    unsigned long long full = chunk == 64 ? ~0ULL : (1ULL << chunk) - 1;
+    wb_stats.stores++;
+    int done = 0;
+    while(done < bytes){
+        unsigned current_address = address + done;
+        unsigned base = current_address - current_address % chunk;
+        write_buffer_entry* entry = NULL;
+        write_buffer_entry* slot = &write_buffer[0];
+        for(int i = 0; i < write_buffer_entries; i++){
+            if(write_buffer[i].valid && write_buffer[i].base == base){
+                entry = &write_buffer[i];
+                break;
+            }
+            if(!slot->valid) continue;     // Keeps the first free entry
+            if(!write_buffer[i].valid || write_buffer[i].last_use < slot->last_use) slot = &write_buffer[i];
+        }
+        if(entry) wb_stats.merges++;
+        else{
+            if(slot->valid){
+                wb_stats.evictions++;
+                write_buffer_drain(slot, move_data);
+            }
+            entry = slot;
+            entry->valid = 1;
+            entry->base = base;
+            entry->mask = 0;
+        }
+        entry->last_use = write_buffer_clock++;
+
+        while(done < bytes && current_address - base < (unsigned)chunk){
+            int offset = current_address - base;
+            entry->mask |= 1ULL << offset;
+            if(move_data) entry->bytes[offset] = (data >> (8 * done)) & 0xff;
+            done++;
+            current_address++;
+        }
+        if(entry->mask == full){
+            wb_stats.full_drains++;
+            write_buffer_drain(entry, move_data);
+        }
+    }
+}
+
+// Function to drain the entries a load overlaps so it reads the stored data from the cache
+void write_buffer_load(unsigned address, int bytes, int move_data){
+    for(int i = 0; i < write_buffer_entries; i++){
+        write_buffer_entry* entry = &write_buffer[i];
+        if(!entry->valid || address >= entry->base + write_buffer_chunk() || address + bytes <= entry->base) continue;
+        wb_stats.load_drains++;
+        write_buffer_drain(entry, move_data);
+    }
+}
+
+// Function to drain every pending store in the order they were last written
+void write_buffer_drain_all(int move_data){
+    while(1){
+        write_buffer_entry* oldest = NULL;
+        for(int i = 0; i < write_buffer_entries; i++){
+            if(write_buffer[i].valid && (oldest == NULL || write_buffer[i].last_use < oldest->last_use)) oldest = &write_buffer[i];
+        }
+        if(oldest == NULL) return;
+        write_buffer_drain(oldest, move_data);
+    }
+}
+
+// Function to reload the buffered data after memory was changed behind the cache
+void cache_buffers_sync_from_memory(){
+    /*
+    After the timing thread only tags and masks were kept, the stores themselves already reached memory,
+    so memory holds exactly what the pending bytes and the victim blocks should contain
+    */
+    for(int i = 0; i < victim_entries; i++){
+        if(!victims[i].valid) continue;
+        read_memory_block(victims[i].block, victims[i].block_address);
+    }
+    for(int i = 0; i < write_buffer_entries; i++){
+        if(!write_buffer[i].valid) continue;
+        for(int j = 0; j < write_buffer_chunk(); j++){
+            if(write_buffer[i].mask >> j & 1) write_buffer[i].bytes[j] = data_section[write_buffer[i].base + j - DATA_START];
+        }
+    }
+}
+
+// Function to copy the dirty victim blocks and the pending store bytes into memory, keeping both structures as they are
+void cache_buffers_publish_to_memory(){
+    for(int i = 0; i < victim_entries; i++){
+        if(!victims[i].valid || !victims[i].dirty) continue;
+        for(int j = 0; j < block_size; j++) data_section[victims[i].block_address + j - DATA_START] = (unsigned char)victims[i].block[j];
+    }
+    for(int i = 0; i < write_buffer_entries; i++){
+        if(!write_buffer[i].valid) continue;
+        for(int j = 0; j < write_buffer_chunk(); j++){
+            if(write_buffer[i].mask >> j & 1) data_section[write_buffer[i].base + j - DATA_START] = (unsigned char)write_buffer[i].bytes[j];
+        }
+    }
+}
+
+// Function to clear both structures and their statistics when a program is loaded
+void cache_buffers_reset(){
+    if(victim_block_size) victim_cache_clear();
+    write_buffer_clear();
+    memset(&vc_stats, 0, sizeof(vc_stats));
+    memset(&wb_stats, 0, sizeof(wb_stats));
+}
+
+void enable_victim_cache(int entries){
+    if(entries < 1 || entries > MAX_VICTIM_ENTRIES){
+        printf("Error: The victim cache holds 1 to %d lines\n", MAX_VICTIM_ENTRIES);
+        return;
+    }
+    if(cache == NULL){
+        printf("Error: Enable the cache with cache_sim enable <file_name> first\n");
+        return;
+    }
+    if(victim_cache_enabled) victim_flush();    // Dirty lines the old victim cache held must not be lost
+    victim_entries = entries;
+    victim_cache_clear();
+    memset(&vc_stats, 0, sizeof(vc_stats));
+    victim_cache_enabled = 1;
+    printf("Victim cache enabled: %d lines\n", entries);
+}
+
+void disable_victim_cache(){
+    if(victim_cache_enabled) victim_flush();
+    victim_cache_enabled = 0;
+    printf("Victim cache disabled\n");
+}
+
+void print_victim_cache_stats(){
+    if(!victim_cache_enabled){
+        printf("Victim cache is disabled\n");
+        return;
+    }
+    printf("Victim cache lookups: %lld, hits: %lld (%.2f%% of cache misses), insertions: %lld, writebacks: %lld\n",
+           vc_stats.lookups, vc_stats.hits, vc_stats.lookups ? 100.0 * vc_stats.hits / vc_stats.lookups : 0.0,
+           vc_stats.insertions, vc_stats.writebacks);
+}
+
+void enable_write_buffer(int entries){
+    if(entries < 1 || entries > MAX_WRITE_BUFFER_ENTRIES){
+        printf("Error: The write buffer holds 1 to %d entries\n", MAX_WRITE_BUFFER_ENTRIES);
+        return;
+    }
+    if(cache == NULL){
+        printf("Error: Enable the cache with cache_sim enable <file_name> first\n");
+        return;
+    }
+    if(write_buffer_enabled) write_buffer_drain_all(1);
+    write_buffer_entries = entries;
+    write_buffer_clear();
+    memset(&wb_stats, 0, sizeof(wb_stats));
+    write_buffer_enabled = 1;
+    printf("Write buffer enabled: %d entries of %d bytes\n", entries, write_buffer_chunk());
+}
+
+void disable_write_buffer(){
+    if(write_buffer_enabled) write_buffer_drain_all(1);
+    write_buffer_enabled = 0;
+    printf("Write buffer disabled\n");
+}
+
+void print_write_buffer_stats(){
+    if(!write_buffer_enabled){
+        printf("Write buffer is disabled\n");
+        return;
+    }
+    printf("Write buffer stores: %lld, merged: %lld (%.2f%%), cache writes: %lld\n", wb_stats.stores, wb_stats.merges,
+           wb_stats.stores ? 100.0 * wb_stats.merges / wb_stats.stores : 0.0, wb_stats.drains);
+    printf("Drains when full: %lld, for a new chunk: %lld, for a load: %lld\n",
+           wb_stats.full_drains, wb_stats.evictions, wb_stats.load_drains);
+}
\ No newline at end of file
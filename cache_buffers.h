@@ -0,0 +1,71 @@
+#include <stdio.h>
+
+#ifndef CACHE_BUFFERS_H
+#define CACHE_BUFFERS_H
+
+#define MAX_VICTIM_ENTRIES 64
+#define MAX_WRITE_BUFFER_ENTRIES 64
+#define WRITE_BUFFER_CHUNK 64       // Widest region one write buffer entry covers, one mask bit per byte
+
+typedef struct{
+    int valid;
+    int dirty;
+    unsigned block_address;
+    long long last_use;
+    char* block;
+} victim_entry;
+
+typedef struct{
+    int valid;
+    unsigned base;                  // Chunk aligned address
+    unsigned long long mask;        // Bytes written so far
+    long long last_use;
+    char bytes[WRITE_BUFFER_CHUNK];
+} write_buffer_entry;
+
+typedef struct{
+    long long lookups;      // Cache misses that searched the victim cache
+    long long hits;         // Misses served by swapping a line back in
+    long long insertions;   // Lines caught on eviction from the cache
+    long long writebacks;   // Dirty lines written back when pushed out of the victim cache
+} victim_stats;
+
+typedef struct{
+    long long stores;       // Stores that entered the buffer
+    long long merges;       // Stores combined into an entry that was already pending
+    long long drains;       // Entries written into the cache
+    long long full_drains;  // Entries drained because every byte had been written
+    long long evictions;    // Entries drained to make room for a new chunk
+    long long load_drains;  // Entries drained because a load overlapped them
+} write_buffer_stats;
+
+extern int victim_cache_enabled, write_buffer_enabled;
+extern victim_stats vc_stats;
+extern write_buffer_stats wb_stats;
+extern victim_entry victims[MAX_VICTIM_ENTRIES];
+extern write_buffer_entry write_buffer[MAX_WRITE_BUFFER_ENTRIES];
+extern int victim_entries, write_buffer_entries;
+extern long long victim_clock, write_buffer_clock;
+
+void enable_victim_cache(int entries);
+void disable_victim_cache();
+void print_victim_cache_stats();
+void victim_cache_clear();
+void victim_insert(unsigned block_address, const char* block, int dirty, int move_data);
+int victim_holds(unsigned block_address);
+char* victim_take(unsigned block_address, int* dirty, int move_data);
+void victim_flush();
+
+void enable_write_buffer(int entries);
+void disable_write_buffer();
+void print_write_buffer_stats();
+void write_buffer_clear();
+void write_buffer_store(unsigned address, long long data, int bytes, int move_data);
+void write_buffer_load(unsigned address, int bytes, int move_data);
+void write_buffer_drain_all(int move_data);
+
+void cache_buffers_reset();
+void cache_buffers_sync_from_memory();
+void cache_buffers_publish_to_memory();
+
+#endif
\ No newline at end of file
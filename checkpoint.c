@@ -0,0 +1,365 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include "simulator.h"
+#include "cache.h"
+#include "checkpoint.h"
+#include "cache_buffers.h"
+
+typedef struct{
+    const char* data;   // The mapped checkpoint file
+    size_t size;
+    size_t offset;
+    int error;          // Set once anything runs past the end of the file
+} checkpoint_reader;
+
+// Function to append a block to the checkpoint, remembering any write error
+void write_block(FILE* fptr, const void* data, size_t length, int* error){
+    if(length > 0 && fwrite(data, 1, length, fptr) != length) *error = 1;
+}
+
+// Function to write a string as a length followed by its characters
+void write_string(FILE* fptr, const char* text, int* error){
+    unsigned short length = strlen(text);
+    write_block(fptr, &length, sizeof(length), error);
+    write_block(fptr, text, length, error);
+}
+
+// Function to return a pointer into the mapped file and move past it
+const char* read_view(checkpoint_reader* reader, size_t length){
+    if(reader->error || length > reader->size - reader->offset){
+        reader->error = 1;
+        return NULL;
+    }
+    const char* view = reader->data + reader->offset;
+    reader->offset += length;
+    return view;
+}
+
+// Function to copy a block out of the mapped file
+void read_block(checkpoint_reader* reader, void* out, size_t length){
+    const char* view = read_view(reader, length);
+    if(view) memcpy(out, view, length);
+    else memset(out, 0, length);
+}
+
+// Function to read a string written by write_string(), truncating to the destination size
+void read_string(checkpoint_reader* reader, char* out, size_t size){
+    unsigned short length;
+    read_block(reader, &length, sizeof(length));
+    const char* view = read_view(reader, length);
+    size_t kept = (length < size - 1) ? length : size - 1;
+    if(view) memcpy(out, view, kept);
+    out[view ? kept : 0] = '\0';
+}
+
+// Function to find the label ID saved for a call stack entry by its name
+int label_by_name(const char* name){
+    for(int i = 0; i < label_count; i++){
+        if(strcmp(labels[i].name, name) == 0) return i;
+    }
+    return MAIN_FRAME;
+}
+
+// Function to check whether a page of guest memory holds anything but zeroes
+int page_touched(int page){
+    int start = page * CHECKPOINT_PAGE_SIZE;
+    for(int i = start; i < start + CHECKPOINT_PAGE_SIZE; i++){
+        if(data_section[i] != 0) return 1;
+    }
+    return 0;
+}
+
+// Function to check that a block saved in the victim cache or write buffer lies inside guest memory
+int buffer_address_valid(unsigned address, int length){
+    return address >= DATA_START && address - DATA_START + length <= STACK_START - DATA_START;
+}
+
+// Function to tell which models a restored checkpoint starts over with
+void print_cold_state(){
+    printf("Branch predictor, prefetcher, TLB, DRAM banks, miss classifier and heatmap are not saved and restart cold.\n");
+}
+
+/*
+Serializes registers, memory, call stack, break points and the full cache state including the victim cache and
+write buffer, both are written as they are so saving does not change the run that continues afterwards
+The branch predictor, prefetcher, TLB, DRAM and the miss classifier and heatmap are left out and start cold on load
+*/
+int save_checkpoint(const char* filename){
+    FILE* fptr = fopen(filename, "wb");
+    if(!fptr){
+        printf("Error: Cannot create checkpoint file %s\n", filename);
+        return 0;
+    }
+    int error = 0;
+    unsigned header[2] = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION};
+    write_block(fptr, header, sizeof(header), &error);
+
+    // Processor state and program
+    write_block(fptr, registers, sizeof(registers), &error);
+    write_block(fptr, &pc, sizeof(pc), &error);
+    write_block(fptr, &stack_pointer, sizeof(stack_pointer), &error);
+    write_block(fptr, &instr_count, sizeof(instr_count), &error);
+    write_block(fptr, &instret, sizeof(instret), &error);
+    write_block(fptr, text_section, instr_count * sizeof(unsigned), &error);
+    for(int i = 0; i < instr_count; i++){
+        write_block(fptr, &instruction_lines[i], sizeof(int), &error);
+        write_string(fptr, instructions[i], &error);
+    }
+    write_block(fptr, &label_count, sizeof(label_count), &error);
+    write_block(fptr, labels, label_count * sizeof(label_info), &error);
+    write_block(fptr, &data_label_count, sizeof(data_label_count), &error);
+    write_block(fptr, data_labels, data_label_count * sizeof(label_info), &error);
+    write_block(fptr, &data_end, sizeof(data_end), &error);
+
+    // Only pages that hold data are saved, memory is one byte per element so each page is packed down
+    int page_count = 0;
+    int total_pages = (STACK_START - DATA_START) / CHECKPOINT_PAGE_SIZE;
+    for(int page = 0; page < total_pages; page++) page_count += page_touched(page);
+    write_block(fptr, &page_count, sizeof(page_count), &error);
+    for(int page = 0; page < total_pages; page++){
+        if(!page_touched(page)) continue;
+        unsigned char bytes[CHECKPOINT_PAGE_SIZE];
+        for(int i = 0; i < CHECKPOINT_PAGE_SIZE; i++) bytes[i] = data_section[page * CHECKPOINT_PAGE_SIZE + i] & 0xff;
+        write_block(fptr, &page, sizeof(page), &error);
+        write_block(fptr, bytes, sizeof(bytes), &error);
+    }
+
+    // Call stack and break points
+    int depth = stack_top + 1;
+    write_block(fptr, &depth, sizeof(depth), &error);
+    for(int i = 0; i < depth; i++){
+        write_block(fptr, &call_stack[i].line_num, sizeof(int), &error);
+        write_string(fptr, frame_name(call_stack[i].label_id), &error);
+    }
+    int break_count = 0;
+    for(int i = 0; i < MAX_INSTRS; i++) break_count += break_points[i] != 0;
+    write_block(fptr, &break_count, sizeof(break_count), &error);
+    for(int i = 0; i < MAX_INSTRS; i++){
+        if(break_points[i]) write_block(fptr, &i, sizeof(i), &error);
+    }
+
+    // Cache configuration, every line and the statistics
+    int has_cache = cache != NULL;
+    write_block(fptr, &has_cache, sizeof(has_cache), &error);
+    write_block(fptr, &cache_enabled, sizeof(cache_enabled), &error);
+    if(has_cache){
+        int config[3] = {cache_size, block_size, associativity};
+        write_block(fptr, config, sizeof(config), &error);
+        write_block(fptr, replacement_policy, sizeof(replacement_policy), &error);
+        write_block(fptr, write_back_policy, sizeof(write_back_policy), &error);
+        for(int i = 0; i < cache->num_sets; i++){
+            write_block(fptr, &cache->sets[i].policy_bits, sizeof(cache->sets[i].policy_bits), &error);
+            for(int j = 0; j < cache->lines_per_set; j++){
+                CacheLine* line = &cache->sets[i].lines[j];
+                int fields[4] = {line->valid, line->dirty, line->frequency, line->prefetched};
+                long long times[3] = {line->last_access_time, line->load_time, line->ready_time};
+                write_block(fptr, fields, sizeof(fields), &error);
+                write_block(fptr, times, sizeof(times), &error);
+                write_block(fptr, &line->tag, sizeof(line->tag), &error);
+                write_block(fptr, line->block, block_size, &error);
+            }
+        }
+        write_block(fptr, &dip_psel, sizeof(dip_psel), &error);
+
+        // Victim cache and write buffer, memory above does not hold their data yet
+        int buffers[4] = {victim_cache_enabled, victim_entries, write_buffer_enabled, write_buffer_entries};
+        long long clocks[2] = {victim_clock, write_buffer_clock};
+        write_block(fptr, buffers, sizeof(buffers), &error);
+        write_block(fptr, clocks, sizeof(clocks), &error);
+        for(int i = 0; i < victim_entries; i++){
+            int fields[2] = {victims[i].valid, victims[i].dirty};
+            write_block(fptr, fields, sizeof(fields), &error);
+            write_block(fptr, &victims[i].block_address, sizeof(victims[i].block_address), &error);
+            write_block(fptr, &victims[i].last_use, sizeof(victims[i].last_use), &error);
+            write_block(fptr, victims[i].block, block_size, &error);
+        }
+        write_block(fptr, write_buffer, write_buffer_entries * sizeof(write_buffer_entry), &error);
+        write_block(fptr, &vc_stats, sizeof(vc_stats), &error);
+        write_block(fptr, &wb_stats, sizeof(wb_stats), &error);
+    }
+    long long stats[4] = {cache_accesses, cache_hits, cache_misses, cache_clock};
+    write_block(fptr, stats, sizeof(stats), &error);
+
+    if(fclose(fptr) != 0 || error){
+        printf("Error: Failed writing checkpoint file %s\n", filename);
+        remove(filename);
+        return 0;
+    }
+    printf("Checkpoint saved to %s (%d memory pages).\n", filename, page_count);
+    print_cold_state();
+    return 1;
+}
+
+// Function to rebuild the simulator from a mapped checkpoint, returns 0 if the file is malformed
+int restore_state(checkpoint_reader* reader){
+    unsigned header[2];
+    read_block(reader, header, sizeof(header));
+    if(header[0] != CHECKPOINT_MAGIC || header[1] != CHECKPOINT_VERSION) return 0;
+
+    read_block(reader, registers, sizeof(registers));
+    read_block(reader, &pc, sizeof(pc));
+    read_block(reader, &stack_pointer, sizeof(stack_pointer));
+    read_block(reader, &instr_count, sizeof(instr_count));
+    read_block(reader, &instret, sizeof(instret));
+    if(instr_count < 0 || instr_count > MAX_INSTRS) return 0;
+    read_block(reader, text_section, instr_count * sizeof(unsigned));
+    for(int i = 0; i < instr_count; i++){
+        read_block(reader, &instruction_lines[i], sizeof(int));
+        read_string(reader, instructions[i], MAX_LINE_LEN);
+    }
+    read_block(reader, &label_count, sizeof(label_count));
+    if(label_count < 0 || label_count > MAX_LABELS) return 0;
+    read_block(reader, labels, label_count * sizeof(label_info));
+    index_labels();
+    read_block(reader, &data_label_count, sizeof(data_label_count));
+    if(data_label_count < 0 || data_label_count > MAX_LABELS) return 0;
+    read_block(reader, data_labels, data_label_count * sizeof(label_info));
+    read_block(reader, &data_end, sizeof(data_end));
+
+    // Memory pages are expanded straight out of the mapping
+    int page_count;
+    read_block(reader, &page_count, sizeof(page_count));
+    for(int i = 0; i < page_count && !reader->error; i++){
+        int page;
+        read_block(reader, &page, sizeof(page));
+        if(page < 0 || page >= (STACK_START - DATA_START) / CHECKPOINT_PAGE_SIZE) return 0;
+        const unsigned char* bytes = (const unsigned char*)read_view(reader, CHECKPOINT_PAGE_SIZE);
+        for(int j = 0; bytes && j < CHECKPOINT_PAGE_SIZE; j++) data_section[page * CHECKPOINT_PAGE_SIZE + j] = bytes[j];
+    }
+
+    int depth;
+    read_block(reader, &depth, sizeof(depth));
+    if(depth < 0 || depth > MAX_CALL_DEPTH) return 0;
+    for(int i = 0; i < depth && !reader->error; i++){
+        char label[MAX_LINE_LEN];
+        int line_num;
+        read_block(reader, &line_num, sizeof(line_num));
+        read_string(reader, label, sizeof(label));
+        push_stack(label_by_name(label));
+        call_stack[stack_top].line_num = line_num;
+    }
+    int break_count;
+    read_block(reader, &break_count, sizeof(break_count));
+    for(int i = 0; i < break_count && !reader->error; i++){
+        int index;
+        read_block(reader, &index, sizeof(index));
+        if(index < 0 || index >= MAX_INSTRS) return 0;
+        break_points[index] = 1;
+    }
+
+    int has_cache, enabled;
+    read_block(reader, &has_cache, sizeof(has_cache));
+    read_block(reader, &enabled, sizeof(enabled));
+    if(has_cache && !reader->error){
+        int config[3];
+        read_block(reader, config, sizeof(config));
+        read_block(reader, replacement_policy, sizeof(replacement_policy));
+        read_block(reader, write_back_policy, sizeof(write_back_policy));
+        replacement_policy[sizeof(replacement_policy) - 1] = '\0';
+        write_back_policy[sizeof(write_back_policy) - 1] = '\0';
+        // The geometry has to describe a cache initialize_cache() can build
+        if(config[0] <= 0 || config[1] <= 0 || config[2] <= 0 || config[0] % (config[1] * config[2]) != 0) return 0;
+        cache_size = config[0];
+        block_size = config[1];
+        associativity = config[2];
+        initialize_cache();
+        for(int i = 0; i < cache->num_sets; i++){
+            read_block(reader, &cache->sets[i].policy_bits, sizeof(cache->sets[i].policy_bits));
+            for(int j = 0; j < cache->lines_per_set; j++){
+                CacheLine* line = &cache->sets[i].lines[j];
+                int fields[4];
+                long long times[3];
+                read_block(reader, fields, sizeof(fields));
+                read_block(reader, times, sizeof(times));
+                line->valid = fields[0];
+                line->dirty = fields[1];
+                line->frequency = fields[2];
+                line->prefetched = fields[3];
+                line->last_access_time = times[0];
+                line->load_time = times[1];
+                line->ready_time = times[2];
+                read_block(reader, &line->tag, sizeof(line->tag));
+                read_block(reader, line->block, block_size);
+            }
+        }
+        read_block(reader, &dip_psel, sizeof(dip_psel));
+
+        int buffers[4];
+        long long clocks[2];
+        read_block(reader, buffers, sizeof(buffers));
+        read_block(reader, clocks, sizeof(clocks));
+        if(buffers[1] < 0 || buffers[1] > MAX_VICTIM_ENTRIES || buffers[3] < 0 || buffers[3] > MAX_WRITE_BUFFER_ENTRIES) return 0;
+        victim_cache_enabled = buffers[0] != 0;
+        victim_entries = buffers[1];
+        write_buffer_enabled = buffers[2] != 0;
+        write_buffer_entries = buffers[3];
+        victim_clock = clocks[0];
+        write_buffer_clock = clocks[1];
+        for(int i = 0; i < victim_entries; i++){
+            int fields[2];
+            read_block(reader, fields, sizeof(fields));
+            read_block(reader, &victims[i].block_address, sizeof(victims[i].block_address));
+            read_block(reader, &victims[i].last_use, sizeof(victims[i].last_use));
+            read_block(reader, victims[i].block, block_size);
+            victims[i].valid = fields[0];
+            victims[i].dirty = fields[1];
+            if(victims[i].valid && !buffer_address_valid(victims[i].block_address, block_size)) return 0;
+        }
+        read_block(reader, write_buffer, write_buffer_entries * sizeof(write_buffer_entry));
+        for(int i = 0; i < write_buffer_entries; i++){
+            if(write_buffer[i].valid && !buffer_address_valid(write_buffer[i].base, block_size < WRITE_BUFFER_CHUNK ? block_size : WRITE_BUFFER_CHUNK)) return 0;
+        }
+        read_block(reader, &vc_stats, sizeof(vc_stats));
+        read_block(reader, &wb_stats, sizeof(wb_stats));
+    }
+    cache_enabled = has_cache && enabled;
+    long long stats[4];
+    read_block(reader, stats, sizeof(stats));
+    cache_accesses = stats[0];
+    cache_hits = stats[1];
+    cache_misses = stats[2];
+    cache_clock = stats[3];
+    return !reader->error;
+}
+
+// Restores the state saved by save_checkpoint(), memory images are read through mmap
+int load_checkpoint(const char* filename){
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0){
+        printf("Error: Cannot open checkpoint file %s\n", filename);
+        return 0;
+    }
+    struct stat st;
+    if(fstat(fd, &st) < 0 || st.st_size == 0){
+        printf("Error: Checkpoint file %s is empty\n", filename);
+        close(fd);
+        return 0;
+    }
+    char* image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED){
+        printf("Error: Cannot map checkpoint file %s\n", filename);
+        return 0;
+    }
+
+    reset();
+    while(stack_top > -1) pop_stack();
+    checkpoint_reader reader = {image, st.st_size, 0, 0};
+    int restored = restore_state(&reader);
+    munmap(image, st.st_size);
+
+    if(!restored){
+        printf("Error: %s is not a valid checkpoint\n", filename);
+        reset();
+        while(stack_top > -1) pop_stack();
+        return 0;
+    }
+    printf("Checkpoint restored from %s, PC = 0x%08x\n", filename, pc);
+    print_cold_state();
+    return 1;
+}
\ No newline at end of file
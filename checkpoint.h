@@ -0,0 +1,13 @@
+#include <stdio.h>
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#define CHECKPOINT_MAGIC 0x4b435652     // "RVCK"
+#define CHECKPOINT_VERSION 5
+#define CHECKPOINT_PAGE_SIZE 4096       // Granularity at which guest memory is saved
+
+int save_checkpoint(const char* filename);
+int load_checkpoint(const char* filename);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "pipeline.h"
+#include "ooo.h"
+#include "dram.h"
+
+/*
+Main memory behind the cache, every block fill is a read and every write-back or write-through store a write
+Addresses map as row | rank | bank | channel | column, so consecutive rows of a stream spread over the channels and banks
+Demand reads are served at once and their latency stalls the instruction that missed, prefetches and writes wait in
+a queue until a later read runs the scheduler or the queue fills up
+A demand access to a prefetched block waits for the fill: a queued fill is promoted to a demand read, and the arrival
+cycle of an issued one is looked up in a short history of fills
+The FR-FCFS scheduler issues the oldest request that hits an open row, or the oldest read if none does,
+so writes mostly go out when the queue is full and do not hold up the reads behind them
+Time is the cycle count of the pipeline or the dispatch cycle of the out-of-order model, without one every cache access takes a cycle
+*/
+int dram_enabled = 0;
+dram_config dram_settings = {1, 1, 8, 2048, 1, 40, 40, 40, 8};
+dram_stats mem_stats;
+long long dram_stall_cycles = 0;
+
+typedef struct{
+    long long open_row;     // -1 when precharged
+    long long ready;        // First cycle the bank accepts a new command
+} dram_bank;
+
+typedef struct{
+    unsigned address;
+    int is_write;
+    int demand;
+    long long arrival;
+    long long order;        // Arrival order, FCFS breaks ties with it
+} dram_request;
+
+typedef struct{
+    unsigned address;
+    long long done;         // Cycle the data of the fill arrives
+} dram_fill;
+
+dram_bank* dram_banks = NULL;
+long long* bus_free = NULL;     // First cycle the data bus of each channel is free
+dram_request dram_queue[DRAM_QUEUE_SIZE];
+int dram_queued = 0;
+long long dram_order = 0;
+dram_fill dram_fills[DRAM_FILL_HISTORY];
+int fill_next = 0;      // Oldest entry of the fill history, overwritten next
+
+// Function to read the DRAM parameters, one per line in the order of dram_config
+int read_dram_config(char* config_file, dram_config* config){
+    FILE* fptr = fopen(config_file, "r");
+    if(fptr == NULL){
+        perror("Error opening file");
+        return 0;
+    }
+    char buffer[50];
+    int line_num = 0;
+    int* fields[9] = {&config->channels, &config->ranks, &config->banks, &config->row_size, &config->open_page,
+                      &config->t_rcd, &config->t_cas, &config->t_rp, &config->t_burst};
+
+    while(fgets(buffer, sizeof(buffer), fptr)){
+        buffer[strcspn(buffer, "\n")] = 0;
+        if(line_num < 9) *fields[line_num] = atoi(buffer);
+        else if(buffer[0] != '\0') printf("Unexpected line in configuration file\n");
+        line_num++;
+    }
+    fclose(fptr);
+    if(config->channels < 1 || config->ranks < 1 || config->banks < 1 || config->row_size < 64 ||
+       (config->row_size & (config->row_size - 1)) || config->t_rcd < 0 || config->t_cas < 0 || config->t_rp < 0 || config->t_burst < 1){
+        printf("Error: Invalid DRAM configuration in %s\n", config_file);
+        return 0;
+    }
+    return 1;
+}
+
+// Function to return the current cycle of the core driving the memory
+long long dram_now(){
+    if(ooo_enabled) return dispatch_cycle + 1;     // A load misses once it issues, the core clock is at the last commit
+    if(pipeline_enabled) return pipe_stats.cycles;
+    return cache_clock + dram_stall_cycles;
+}
+
+// Function to split an address into its channel, bank and row, the bank index counts over all channels and ranks
+void dram_map(unsigned address, int* channel, int* bank, long long* row){
+    unsigned long long rest = address / dram_settings.row_size;
+    *channel = rest % dram_settings.channels;
+    rest /= dram_settings.channels;
+    int bank_in_rank = rest % dram_settings.banks;
+    rest /= dram_settings.banks;
+    int rank = rest % dram_settings.ranks;
+    *row = rest / dram_settings.ranks;
+    *bank = (*channel * dram_settings.ranks + rank) * dram_settings.banks + bank_in_rank;
+}
+
+// Function to issue one request to its bank, returns the cycle its data transfer ends
+long long dram_issue(dram_request* request){
+    int channel, bank_index;
+    long long row;
+    dram_map(request->address, &channel, &bank_index, &row);
+    dram_bank* bank = &dram_banks[bank_index];
+
+    long long start = request->arrival > bank->ready ? request->arrival : bank->ready;
+    int command;
+    if(bank->open_row == row){
+        command = dram_settings.t_cas;
+        mem_stats.row_hits++;
+    }
+    else if(bank->open_row < 0){
+        command = dram_settings.t_rcd + dram_settings.t_cas;
+        mem_stats.row_empty++;
+    }
+    else{
+        command = dram_settings.t_rp + dram_settings.t_rcd + dram_settings.t_cas;
+        mem_stats.row_conflicts++;
+    }
+    long long data = start + command > bus_free[channel] ? start + command : bus_free[channel];
+    long long done = data + dram_settings.t_burst;
+    bus_free[channel] = done;
+    if(dram_settings.open_page){
+        // The next column command to the open row can follow as soon as this burst is off the bus
+        bank->open_row = row;
+        bank->ready = data - dram_settings.t_cas + dram_settings.t_burst;
+    }
+    else{
+        bank->open_row = -1;
+        bank->ready = done + dram_settings.t_rp;
+    }
+
+    if(request->is_write) mem_stats.writes++;
+    else mem_stats.reads++;
+    mem_stats.bytes += block_size;
+    if(mem_stats.reads + mem_stats.writes == 1 || request->arrival < mem_stats.first_arrival) mem_stats.first_arrival = request->arrival;
+    if(done > mem_stats.last_done) mem_stats.last_done = done;
+    return done;
+}
+
+// Function to pick the next request by FR-FCFS among those that arrived by the given cycle
+int dram_pick(long long now){
+    int best = -1, best_priority = 0;
+    for(int i = 0; i < dram_queued; i++){
+        dram_request* request = &dram_queue[i];
+        if(request->arrival > now) continue;
+        int channel, bank;
+        long long row;
+        dram_map(request->address, &channel, &bank, &row);
+        // Row hits first, then reads ahead of writes, then the oldest
+        int priority = (dram_banks[bank].open_row == row) * 2 + !request->is_write;
+        if(best < 0 || priority > best_priority || (priority == best_priority && request->order < dram_queue[best].order)){
+            best = i;
+            best_priority = priority;
+        }
+    }
+    if(best >= 0) return best;
+    for(int i = 0; i < dram_queued; i++){      // Nothing has arrived yet, the earliest goes first
+        if(best < 0 || dram_queue[i].arrival < dram_queue[best].arrival) best = i;
+    }
+    return best;
+}
+
+// Function to issue the request at a queue position and remove it from the queue
+long long dram_serve(int index){
+    dram_request request = dram_queue[index];
+    dram_queue[index] = dram_queue[--dram_queued];
+    long long done = dram_issue(&request);
+    if(!request.is_write && !request.demand){
+        dram_fills[fill_next].address = request.address;
+        dram_fills[fill_next].done = done;
+        fill_next = (fill_next + 1) % DRAM_FILL_HISTORY;
+    }
+    return done;
+}
+
+// Function to add a request to the queue, serving one first if it is full
+void dram_enqueue(unsigned address, int is_write, int demand, long long now){
+    if(dram_queued == DRAM_QUEUE_SIZE) dram_serve(dram_pick(now));
+    dram_request* request = &dram_queue[dram_queued++];
+    request->address = address - address % block_size;
+    request->is_write = is_write;
+    request->demand = demand;
+    request->arrival = now;
+    request->order = dram_order++;
+}
+
+// Function to serve requests in scheduler order until the queued demand read is done, returns the cycle its data arrives
+long long dram_serve_demand(long long now){
+    while(1){
+        int index = dram_pick(now);
+        int demand = dram_queue[index].demand;
+        long long done = dram_serve(index);
+        if(demand) return done;     // Only one demand read is ever queued
+    }
+}
+
+// Function to read a block on a demand miss, returns the cycles the core waits for it
+long long dram_read(unsigned address){
+    long long now = dram_now();
+    dram_enqueue(address, 0, 1, now);
+    long long done = dram_serve_demand(now);
+    mem_stats.demand_reads++;
+    mem_stats.demand_latency += done - now;
+    return done - now;
+}
+
+// Function to find when the prefetch fill of a block arrives, returns the cycles a demand access still waits for it
+long long dram_fill_wait(unsigned address){
+    long long now = dram_now();
+    address -= address % block_size;
+    for(int i = 0; i < dram_queued; i++){
+        if(dram_queue[i].address != address || dram_queue[i].is_write) continue;
+        dram_queue[i].demand = 1;   // Not issued yet, the access promotes it to a demand read
+        long long done = dram_serve_demand(now);
+        return done > now ? done - now : 0;
+    }
+    for(int i = 1; i <= DRAM_FILL_HISTORY; i++){    // Newest first, a block may have been fetched more than once
+        dram_fill* fill = &dram_fills[(fill_next - i + DRAM_FILL_HISTORY) % DRAM_FILL_HISTORY];
+        if(fill->address == address) return fill->done > now ? fill->done - now : 0;
+    }
+    return 0;   // Issued so long ago that it has arrived
+}
+
+// Function to queue a request nobody waits for, a prefetch fill or a write
+void dram_post(unsigned address, int is_write){
+    dram_enqueue(address, is_write, 0, dram_now());
+}
+
+// Function to serve everything still queued
+void dram_drain(){
+    while(dram_queued > 0) dram_serve(dram_pick(LLONG_MAX));
+}
+
+// Function to close every row and clear the queue and the statistics
+void dram_reset(){
+    free(dram_banks);
+    free(bus_free);
+    int total_banks = dram_settings.channels * dram_settings.ranks * dram_settings.banks;
+    dram_banks = malloc(total_banks * sizeof(dram_bank));
+    for(int i = 0; i < total_banks; i++){
+        dram_banks[i].open_row = -1;
+        dram_banks[i].ready = 0;
+    }
+    bus_free = calloc(dram_settings.channels, sizeof(long long));
+    dram_queued = 0;
+    dram_order = 0;
+    memset(dram_fills, 0, sizeof(dram_fills));
+    fill_next = 0;
+    dram_stall_cycles = 0;
+    memset(&mem_stats, 0, sizeof(mem_stats));
+}
+
+// Function to put the DRAM model behind the cache, the parameters stay at their defaults without a config file
+void enable_dram(char* config_file){
+    dram_config config = {1, 1, 8, 2048, 1, 40, 40, 40, 8};
+    if(config_file != NULL && !read_dram_config(config_file, &config)) return;
+    dram_settings = config;
+    dram_reset();
+    dram_enabled = 1;
+    printf("DRAM model enabled: %d channels, %d ranks, %d banks, %d byte rows, %s page, tRCD %d, tCAS %d, tRP %d, burst %d\n",
+           config.channels, config.ranks, config.banks, config.row_size, config.open_page ? "open" : "closed",
+           config.t_rcd, config.t_cas, config.t_rp, config.t_burst);
+}
+
+void disable_dram(){
+    dram_enabled = 0;
+    printf("DRAM model disabled\n");
+}
+
+void print_dram_stats(){
+    if(!dram_enabled){
+        printf("DRAM model is disabled\n");
+        return;
+    }
+    // Queued requests are counted by serving them on a copy of the model, so reporting leaves later timing alone
+    int total_banks = dram_settings.channels * dram_settings.ranks * dram_settings.banks;
+    dram_bank* saved_banks = malloc(total_banks * sizeof(dram_bank));
+    long long* saved_bus = malloc(dram_settings.channels * sizeof(long long));
+    dram_request saved_queue[DRAM_QUEUE_SIZE];
+    memcpy(saved_banks, dram_banks, total_banks * sizeof(dram_bank));
+    memcpy(saved_bus, bus_free, dram_settings.channels * sizeof(long long));
+    memcpy(saved_queue, dram_queue, sizeof(dram_queue));
+    int saved_queued = dram_queued;
+    dram_fill saved_fills[DRAM_FILL_HISTORY];
+    memcpy(saved_fills, dram_fills, sizeof(dram_fills));
+    int saved_next = fill_next;
+    dram_stats saved_stats = mem_stats;
+    dram_drain();
+    long long accesses = mem_stats.row_hits + mem_stats.row_empty + mem_stats.row_conflicts;
+    long long span = mem_stats.last_done - mem_stats.first_arrival;
+    printf("DRAM reads: %lld, writes: %lld, row hits: %lld, empty: %lld, conflicts: %lld (row-buffer hit rate %.4f)\n",
+           mem_stats.reads, mem_stats.writes, mem_stats.row_hits, mem_stats.row_empty, mem_stats.row_conflicts,
+           accesses ? (double)mem_stats.row_hits / accesses : 0.0);
+    printf("Average demand read latency: %.2f cycles over %lld reads, bandwidth: %.3f bytes/cycle (%lld bytes in %lld cycles)\n",
+           mem_stats.demand_reads ? (double)mem_stats.demand_latency / mem_stats.demand_reads : 0.0, mem_stats.demand_reads,
+           span > 0 ? (double)mem_stats.bytes / span : 0.0, mem_stats.bytes, span);
+    if(saved_queued > 0) printf("Still queued (counted above): %d requests\n", saved_queued);
+
+    memcpy(dram_banks, saved_banks, total_banks * sizeof(dram_bank));
+    memcpy(bus_free, saved_bus, dram_settings.channels * sizeof(long long));
+    memcpy(dram_queue, saved_queue, sizeof(dram_queue));
+    dram_queued = saved_queued;
+    memcpy(dram_fills, saved_fills, sizeof(dram_fills));
+    fill_next = saved_next;
+    mem_stats = saved_stats;
+    free(saved_banks);
+    free(saved_bus);
+}
\ No newline at end of file
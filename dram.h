@@ -0,0 +1,48 @@
+#include <stdio.h>
+
+#ifndef DRAM_H
+#define DRAM_H
+
+#define DRAM_QUEUE_SIZE 32      // Requests waiting for the scheduler
+#define DRAM_FILL_HISTORY 64    // Issued prefetch fills remembered for demand accesses that catch up with them
+
+typedef struct{
+    int channels;
+    int ranks;              // Per channel
+    int banks;              // Per rank
+    int row_size;           // Bytes held by one row buffer
+    int open_page;          // 1 keeps rows open after an access, 0 precharges right away
+    int t_rcd;              // Activate to column command, in core cycles
+    int t_cas;              // Column command to data
+    int t_rp;               // Precharge
+    int t_burst;            // Cycles one block occupies the data bus
+} dram_config;
+
+typedef struct{
+    long long reads;            // Block fills, demand and prefetch
+    long long writes;           // Write-backs and write-through stores
+    long long row_hits;
+    long long row_empty;        // Accesses to a precharged bank
+    long long row_conflicts;    // Accesses that had to close another row first
+    long long demand_reads;
+    long long demand_latency;   // Cycles from arrival to data, summed over demand reads
+    long long bytes;
+    long long first_arrival;
+    long long last_done;
+} dram_stats;
+
+extern int dram_enabled;
+extern dram_config dram_settings;
+extern dram_stats mem_stats;
+extern long long dram_stall_cycles;     // Demand read latency, added to the retired instruction that missed
+
+void enable_dram(char* config_file);
+void disable_dram();
+void dram_reset();
+long long dram_read(unsigned address);
+long long dram_fill_wait(unsigned address);
+void dram_post(unsigned address, int is_write);
+void dram_drain();
+void print_dram_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<elf.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include "simulator.h"
+#include "elf_loader.h"
+
+// Function to check for the ELF magic number without disturbing the file position
+int is_elf_file(FILE* fptr){
+    unsigned char magic[SELFMAG];
+    rewind(fptr);
+    size_t length = fread(magic, 1, SELFMAG, fptr);
+    rewind(fptr);
+    return length == SELFMAG && memcmp(magic, ELFMAG, SELFMAG) == 0;
+}
+
+// Function to check that length bytes at offset lie inside a file of the given size, without overflowing
+int fits_in_file(unsigned long long offset, unsigned long long length, size_t size){
+    return offset <= size && length <= size - offset;
+}
+
+// Function to copy one PT_LOAD segment into guest memory
+int map_segment(const char* image, Elf64_Phdr* segment){
+    /*
+    Text goes into text_section and everything from DATA_START up into data_section
+    The bytes come straight out of the mapped file; the part of the segment past
+    p_filesz is .bss and stays zero since reset() cleared memory
+    */
+    unsigned long long start = segment->p_vaddr;
+    if(segment->p_filesz > segment->p_memsz){
+        printf("Error: Segment at 0x%llx has more file bytes than memory bytes\n", start);
+        return 0;
+    }
+    // Written so a huge p_vaddr or p_memsz cannot wrap around
+    if(start > STACK_START || segment->p_memsz > STACK_START - start){
+        printf("Error: Segment at 0x%llx of 0x%llx bytes lies outside guest memory (0x%x-0x%x)\n",
+               start, (unsigned long long)segment->p_memsz, TEXT_START, STACK_START);
+        return 0;
+    }
+    unsigned long long end = start + segment->p_memsz;
+    const unsigned char* bytes = (const unsigned char*)image + segment->p_offset;
+    unsigned long long copied = 0;
+
+    // Text that is word aligned is copied as a block, text_section already holds little endian words
+    if(start < DATA_START && start % 4 == 0){
+        unsigned long long text_bytes = (end < DATA_START ? end : DATA_START) - start;
+        if(text_bytes > segment->p_filesz) text_bytes = segment->p_filesz;
+        memcpy((char*)text_section + start, bytes, text_bytes);
+        copied = text_bytes;
+    }
+    for(unsigned long long i = copied; i < segment->p_filesz; i++){
+        unsigned long long address = start + i;
+        if(address < DATA_START) ((unsigned char*)text_section)[address] = bytes[i];
+        else data_section[address - DATA_START] = bytes[i];     // Memory holds one byte per element
+    }
+    if(start < DATA_START){
+        unsigned long long text_end = (end < DATA_START ? end : DATA_START);
+        if((text_end + 3) / 4 > (unsigned long long)instr_count) instr_count = (text_end + 3) / 4;
+    }
+    return 1;
+}
+
+// Function to load function symbols as labels so call stack tracking can name them
+void load_symbols(const char* image, size_t size, Elf64_Ehdr* header){
+    if(header->e_shoff == 0 || !fits_in_file(header->e_shoff, header->e_shnum * sizeof(Elf64_Shdr), size)) return;
+    Elf64_Shdr* sections = (Elf64_Shdr*)(image + header->e_shoff);
+
+    for(int i = 0; i < header->e_shnum; i++){
+        if(sections[i].sh_type != SHT_SYMTAB || sections[i].sh_link >= header->e_shnum) continue;
+        Elf64_Shdr* strings = &sections[sections[i].sh_link];
+        if(!fits_in_file(sections[i].sh_offset, sections[i].sh_size, size) || !fits_in_file(strings->sh_offset, strings->sh_size, size)) return;
+
+        Elf64_Sym* symbols = (Elf64_Sym*)(image + sections[i].sh_offset);
+        int symbol_count = sections[i].sh_size / sizeof(Elf64_Sym);
+        for(int j = 0; j < symbol_count && label_count < MAX_LABELS; j++){
+            if(symbols[j].st_name >= strings->sh_size) continue;
+            const char* name = image + strings->sh_offset + symbols[j].st_name;
+            if(memchr(name, '\0', strings->sh_size - symbols[j].st_name) == NULL) continue;  // Unterminated name
+            if(strcmp(name, "__global_pointer$") == 0) registers[3] = symbols[j].st_value;  // gp, for relaxed accesses
+
+            if(ELF64_ST_TYPE(symbols[j].st_info) == STT_OBJECT && symbols[j].st_value >= DATA_START &&
+               symbols[j].st_value < STACK_START && data_label_count < MAX_LABELS){
+                // Data symbols name regions for the cache heat map
+                strncpy(data_labels[data_label_count].name, name, MAX_LABEL_LEN - 1);
+                data_labels[data_label_count].name[MAX_LABEL_LEN - 1] = '\0';
+                data_labels[data_label_count++].address = symbols[j].st_value;
+                unsigned long long end = symbols[j].st_value + symbols[j].st_size;
+                if(end > data_end) data_end = end < STACK_START ? end : STACK_START;
+            }
+            if(ELF64_ST_TYPE(symbols[j].st_info) != STT_FUNC || symbols[j].st_value >= DATA_START) continue;
+            strncpy(labels[label_count].name, name, MAX_LABEL_LEN - 1);
+            labels[label_count].name[MAX_LABEL_LEN - 1] = '\0';  // Long names are truncated
+            labels[label_count].address = symbols[j].st_value;
+            label_count++;
+        }
+        return;
+    }
+}
+
+// Loads a statically linked RV64 executable into guest memory
+int load_elf(const char* filename){
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0){
+        printf("Error: Cannot open file %s\n", filename);
+        return 0;
+    }
+    struct stat st;
+    if(fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(Elf64_Ehdr)){
+        printf("Error: %s is too small to be an ELF executable\n", filename);
+        close(fd);
+        return 0;
+    }
+    char* image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED){
+        printf("Error: Cannot map file %s\n", filename);
+        return 0;
+    }
+
+    Elf64_Ehdr* header = (Elf64_Ehdr*)image;
+    int loaded = 0;
+    // Checking that this is something the simulator can actually run
+    if(header->e_ident[EI_CLASS] != ELFCLASS64 || header->e_ident[EI_DATA] != ELFDATA2LSB)
+        printf("Error: %s is not a little endian 64-bit ELF file\n", filename);
+    else if(header->e_machine != EM_RISCV)
+        printf("Error: %s is not a RISC-V executable\n", filename);
+    else if(header->e_flags & EF_RISCV_RVC)
+        printf("Error: %s uses compressed (RVC) instructions, which are not supported; build it without the C extension (e.g. -march=rv64im)\n", filename);
+    else if(header->e_type != ET_EXEC)
+        printf("Error: %s is not statically linked (only ET_EXEC is supported)\n", filename);
+    else if(!fits_in_file(header->e_phoff, header->e_phnum * sizeof(Elf64_Phdr), st.st_size))
+        printf("Error: %s has a truncated program header table\n", filename);
+    else if(header->e_entry >= DATA_START)
+        printf("Error: Entry point 0x%llx is outside the text section\n", (unsigned long long)header->e_entry);
+    else loaded = 1;
+
+    Elf64_Phdr* segments = (Elf64_Phdr*)(image + header->e_phoff);
+    for(int i = 0; loaded && i < header->e_phnum; i++){
+        if(segments[i].p_type != PT_LOAD) continue;
+        if(!fits_in_file(segments[i].p_offset, segments[i].p_filesz, st.st_size)){
+            printf("Error: Segment %d of %s is truncated\n", i, filename);
+            loaded = 0;
+        }
+        else loaded = map_segment(image, &segments[i]);
+    }
+
+    if(loaded){
+        load_symbols(image, st.st_size, header);
+        // There is no source text, so the line table shows raw words and word indices
+        for(int i = 0; i < instr_count; i++){
+            snprintf(instructions[i], MAX_LINE_LEN, "0x%08x", text_section[i]);
+            instruction_lines[i] = i + 1;
+        }
+        pc = header->e_entry;
+        registers[2] = STACK_START;     // sp, compiled code expects a valid stack
+
+        index_labels();
+        int entry_id = label_at_address(pc);
+        push_stack(entry_id >= 0 ? entry_id : MAIN_FRAME);
+        printf("Loaded %d instructions into text section from %s (ELF, entry 0x%x, %d symbols).\n", instr_count, filename, pc, label_count);
+    }
+    munmap(image, st.st_size);
+    return loaded;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include <stdio.h>
+
+#ifndef ELF_LOADER_H
+#define ELF_LOADER_H
+
+int is_elf_file(FILE* fptr);
+int load_elf(const char* filename);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "heatmap.h"
+
+/*
+Accesses, misses and evictions are counted per cache set and per address region
+The regions are rebuilt after every load: one per .data label (up to the next label or the end of the initialized data),
+the unlabelled part of .data, the heap between the data and the stack, the stack, and the regions added by hand,
+which take precedence over the others
+Each block maps to the region holding its first byte through a table indexed by block number
+*/
+int heatmap_enabled = 0;
+
+heat_counters* set_heat = NULL;
+int heat_sets = 0;
+
+heat_region regions[MAX_HEAT_REGIONS];
+int region_count = 0;
+heat_region user_regions[MAX_USER_REGIONS];
+int user_region_count = 0;
+short* block_region = NULL;     // Region of each block of data memory, -1 for none
+int regions_stale = 1;
+
+// Function to append a region, returns its index or -1 if the table is full
+int push_region(const char* name, unsigned start, unsigned end){
+    if(region_count == MAX_HEAT_REGIONS || start >= end) return -1;
+    heat_region* region = &regions[region_count];
+    strncpy(region->name, name, MAX_LABEL_LEN - 1);
+    region->name[MAX_LABEL_LEN - 1] = '\0';
+    region->start = start;
+    region->end = end;
+    memset(&region->counts, 0, sizeof(heat_counters));
+    return region_count++;
+}
+
+// Comparison function for qsort, orders labels by address
+int compare_label_address(const void* a, const void* b){
+    const label_info* x = a;
+    const label_info* y = b;
+    return (x->address > y->address) - (x->address < y->address);
+}
+
+// Function to rebuild the region list and the block table from the current labels and cache geometry
+void build_regions(){
+    region_count = 0;
+    label_info sorted[MAX_LABELS];
+    memcpy(sorted, data_labels, data_label_count * sizeof(label_info));
+    qsort(sorted, data_label_count, sizeof(label_info), compare_label_address);
+
+    unsigned stack_start = STACK_START - HEAT_STACK_SIZE;
+    unsigned static_end = data_end > stack_start ? stack_start : data_end;
+    unsigned first_label = data_label_count ? (unsigned)sorted[0].address : static_end;
+    push_region(".data", DATA_START, first_label < static_end ? first_label : static_end);
+    for(int i = 0; i < data_label_count; i++){
+        unsigned start = sorted[i].address;     // Label addresses are ints, regions are unsigned
+        unsigned end = i + 1 < data_label_count ? (unsigned)sorted[i + 1].address : static_end;
+        push_region(sorted[i].name, start, end > start ? end : start + 1);
+    }
+    push_region("heap", static_end, stack_start);
+    push_region("stack", stack_start, STACK_START);
+    for(int i = 0; i < user_region_count; i++) push_region(user_regions[i].name, user_regions[i].start, user_regions[i].end);
+
+    int blocks = (STACK_START - DATA_START) / block_size;
+    free(block_region);
+    block_region = malloc(blocks * sizeof(short));
+    memset(block_region, 0xff, blocks * sizeof(short));     // -1 everywhere
+    for(int r = 0; r < region_count; r++){     // Later regions win, so hand-made ones override the labels
+        unsigned start = regions[r].start < DATA_START ? DATA_START : regions[r].start;
+        unsigned end = regions[r].end > STACK_START ? STACK_START : regions[r].end;
+        for(unsigned block = (start - DATA_START + block_size - 1) / block_size; block * block_size < end - DATA_START; block++){
+            block_region[block] = r;
+        }
+    }
+    regions_stale = 0;
+}
+
+// Function to clear every counter, the regions are rebuilt on the next access
+void heatmap_reset(){
+    regions_stale = 1;
+    if(!heatmap_enabled || cache == NULL) return;
+    free(set_heat);
+    heat_sets = cache->num_sets;
+    set_heat = calloc(heat_sets, sizeof(heat_counters));
+}
+
+// Function to count a demand access in its set and region
+void heat_access(unsigned block_address, int set_index, int missed){
+    if(regions_stale) build_regions();
+    if(set_index < heat_sets){
+        set_heat[set_index].accesses++;
+        set_heat[set_index].misses += missed;
+    }
+    if(block_address < DATA_START || block_address >= STACK_START) return;
+    int region = block_region[(block_address - DATA_START) / block_size];
+    if(region >= 0){
+        regions[region].counts.accesses++;
+        regions[region].counts.misses += missed;
+    }
+}
+
+// Function to count a line leaving the cache, charged to the set and to the region of the evicted block
+void heat_eviction(unsigned block_address, int set_index){
+    if(regions_stale) build_regions();
+    if(set_index < heat_sets) set_heat[set_index].evictions++;
+    if(block_address < DATA_START || block_address >= STACK_START) return;
+    int region = block_region[(block_address - DATA_START) / block_size];
+    if(region >= 0) regions[region].counts.evictions++;
+}
+
+void add_heat_region(const char* name, unsigned start, unsigned end){
+    if(start >= end || start < DATA_START || end > STACK_START){
+        printf("Error: A region must lie within data memory 0x%x to 0x%x\n", DATA_START, STACK_START);
+        return;
+    }
+    if(user_region_count == MAX_USER_REGIONS){
+        printf("Error: At most %d regions can be added\n", MAX_USER_REGIONS);
+        return;
+    }
+    heat_region* region = &user_regions[user_region_count++];
+    strncpy(region->name, name, MAX_LABEL_LEN - 1);
+    region->name[MAX_LABEL_LEN - 1] = '\0';
+    region->start = start;
+    region->end = end;
+    regions_stale = 1;  // Counts of the regions start over
+    printf("Region %s added: 0x%x to 0x%x\n", region->name, start, end);
+}
+
+void enable_heatmap(){
+    if(cache == NULL){
+        printf("Error: Enable the cache with cache_sim enable <file_name> first\n");
+        return;
+    }
+    heatmap_enabled = 1;
+    heatmap_reset();
+    printf("Cache heat map enabled\n");
+}
+
+void disable_heatmap(){
+    heatmap_enabled = 0;
+    printf("Cache heat map disabled\n");
+}
+
+// Comparison function for qsort, sets with the most misses first
+int compare_set_misses(const void* a, const void* b){
+    long long x = set_heat[*(const int*)a].misses, y = set_heat[*(const int*)b].misses;
+    return (x < y) - (x > y);
+}
+
+void print_heatmap(int top){
+    if(!heatmap_enabled){
+        printf("Cache heat map is disabled\n");
+        return;
+    }
+    if(regions_stale) build_regions();
+    long long total_misses = 0;
+    for(int i = 0; i < heat_sets; i++) total_misses += set_heat[i].misses;
+
+    printf("Regions:\n  %-24s %-10s %-10s %12s %12s %9s %12s\n", "Region", "Start", "End", "Accesses", "Misses", "Miss rate", "Evictions");
+    for(int r = 0; r < region_count; r++){
+        heat_counters* counts = &regions[r].counts;
+        if(counts->accesses == 0 && counts->evictions == 0) continue;
+        printf("  %-24s 0x%08x 0x%08x %12lld %12lld %9.4f %12lld\n", regions[r].name, regions[r].start, regions[r].end,
+               counts->accesses, counts->misses, counts->accesses ? (double)counts->misses / counts->accesses : 0.0, counts->evictions);
+    }
+
+    // One character per set, darker for more misses relative to the worst set
+    const char* shades = " .:-=+*#%@";
+    long long worst = 0;
+    for(int i = 0; i < heat_sets; i++) if(set_heat[i].misses > worst) worst = set_heat[i].misses;
+    printf("Misses per set (' ' none to '@' %lld):\n", worst);
+    for(int i = 0; i < heat_sets; i += 64){
+        printf("  %6d |", i);
+        for(int j = i; j < i + 64 && j < heat_sets; j++){
+            int shade = worst ? (int)((set_heat[j].misses * 9 + worst - 1) / worst) : 0;
+            putchar(shades[shade]);
+        }
+        printf("|\n");
+    }
+
+    int* order = malloc(heat_sets * sizeof(int));
+    for(int i = 0; i < heat_sets; i++) order[i] = i;
+    qsort(order, heat_sets, sizeof(int), compare_set_misses);
+    printf("Top sets:\n  %-8s %12s %12s %9s %12s %9s\n", "Set", "Accesses", "Misses", "Miss rate", "Evictions", "Share");
+    for(int k = 0; k < heat_sets && k < top && set_heat[order[k]].misses > 0; k++){
+        heat_counters* counts = &set_heat[order[k]];
+        printf("  %-8d %12lld %12lld %9.4f %12lld %8.2f%%\n", order[k], counts->accesses, counts->misses,
+               counts->accesses ? (double)counts->misses / counts->accesses : 0.0, counts->evictions, 100.0 * counts->misses / total_misses);
+    }
+    free(order);
+}
+
+void write_heatmap_csv(const char* filename){
+    if(!heatmap_enabled){
+        printf("Cache heat map is disabled\n");
+        return;
+    }
+    FILE* fptr = fopen(filename, "w");
+    if(fptr == NULL){
+        printf("Error: Cannot create file %s\n", filename);
+        return;
+    }
+    if(regions_stale) build_regions();
+    fprintf(fptr, "kind,name,start,end,accesses,misses,evictions\n");
+    for(int r = 0; r < region_count; r++){
+        fprintf(fptr, "region,%s,0x%x,0x%x,%lld,%lld,%lld\n", regions[r].name, regions[r].start, regions[r].end,
+                regions[r].counts.accesses, regions[r].counts.misses, regions[r].counts.evictions);
+    }
+    for(int i = 0; i < heat_sets; i++){
+        fprintf(fptr, "set,%d,,,%lld,%lld,%lld\n", i, set_heat[i].accesses, set_heat[i].misses, set_heat[i].evictions);
+    }
+    fclose(fptr);
+    printf("Heat map written to %s\n", filename);
+}
\ No newline at end of file
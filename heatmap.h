@@ -0,0 +1,36 @@
+#include <stdio.h>
+
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include "assembler.h"
+
+#define HEATMAP_TOP 16              // Sets listed by default in the report
+#define HEAT_STACK_SIZE 0x10000     // Top of data memory counted as the stack region
+#define MAX_HEAT_REGIONS (MAX_LABELS + 16)
+#define MAX_USER_REGIONS 16
+
+typedef struct{
+    long long accesses;
+    long long misses;
+    long long evictions;    // Valid lines replaced by demand or prefetch fills
+} heat_counters;
+
+typedef struct{
+    char name[MAX_LABEL_LEN];
+    unsigned start, end;    // Byte range, end excluded
+    heat_counters counts;
+} heat_region;
+
+extern int heatmap_enabled;
+
+void enable_heatmap();
+void disable_heatmap();
+void heatmap_reset();
+void heat_access(unsigned block_address, int set_index, int missed);
+void heat_eviction(unsigned block_address, int set_index);
+void add_heat_region(const char* name, unsigned start, unsigned end);
+void print_heatmap(int top);
+void write_heatmap_csv(const char* filename);
+
+#endif
\ No newline at end of file
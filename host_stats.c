@@ -0,0 +1,70 @@
+#include<stdio.h>  // Necessary header files imported
+#include<string.h>
+#include<time.h>
+#include "cache.h"
+#include "host_stats.h"
+
+/*
+Ticks are converted to seconds with a rate measured against the monotonic clock between
+host_stats_init() and the report, which also covers hosts where host_ticks() is already in nanoseconds
+*/
+host_timer_stats host_timers[HOST_TIMER_COUNT];
+host_event_stats host_events;
+int host_cache_timing = 0;      // Timing every lookup costs about as much as the lookup itself
+unsigned long long calibration_ticks;
+double calibration_seconds;
+
+const char* host_timer_names[HOST_TIMER_COUNT] = {
+    "load", "  section scan", "  label pass", "  encode", "  data directives",
+    "run loop", "  cache lookups", "  trace output"
+};
+
+// Function to read the monotonic clock in seconds
+double monotonic_seconds(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Function to start the session clock used to calibrate ticks
+void host_stats_init(){
+    calibration_ticks = host_ticks();
+    calibration_seconds = monotonic_seconds();
+}
+
+// Function to clear every timer and event counter
+void host_stats_reset(){
+    memset(host_timers, 0, sizeof(host_timers));
+    memset(&host_events, 0, sizeof(host_events));
+    cache_allocations = 0;
+    cache_writebacks = 0;
+}
+
+// Function to print the time spent in each host phase and the host event counts
+void print_host_stats(){
+    double elapsed = monotonic_seconds() - calibration_seconds;
+    unsigned long long ticks = host_ticks() - calibration_ticks;
+    double seconds_per_tick = ticks > 0 ? elapsed / ticks : 0;
+
+    printf("Host time over %.3f seconds:\n", elapsed);
+    printf("%-20s %12s %12s %14s\n", "Phase", "Seconds", "Calls", "ns/call");
+    for(int i = 0; i < HOST_TIMER_COUNT; i++){
+        if(i == HOST_CACHE && !host_cache_timing && host_timers[i].calls == 0) continue;
+        double seconds = host_timers[i].ticks * seconds_per_tick;
+        printf("%-20s %12.6f %12lld %14.1f\n", host_timer_names[i], seconds, host_timers[i].calls,
+               host_timers[i].calls ? seconds * 1e9 / host_timers[i].calls : 0.0);
+    }
+    // Whatever the run loop spent outside the cache model and the trace is interpreter time
+    unsigned long long nested = host_timers[HOST_CACHE].ticks + host_timers[HOST_OUTPUT].ticks;
+    unsigned long long interpreter = host_timers[HOST_RUN].ticks > nested ? host_timers[HOST_RUN].ticks - nested : 0;
+    printf("%-20s %12.6f\n", "  interpreter", interpreter * seconds_per_tick);
+    if(!host_cache_timing) printf("(cache lookups are not timed separately, enable with stats host cache on)\n");
+
+    double run_seconds = host_timers[HOST_RUN].ticks * seconds_per_tick;
+    printf("Host events:\n");
+    printf("Instructions interpreted: %lld", host_events.instructions);
+    if(run_seconds > 0) printf(" (%.2f MIPS in the run loop)", host_events.instructions / run_seconds / 1e6);
+    printf("\nCache line allocations: %lld\n", cache_allocations);
+    printf("Cache write-backs: %lld\n", cache_writebacks);
+    printf("Trace bytes written: %lld\n", host_events.trace_bytes);
+}
\ No newline at end of file
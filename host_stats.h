@@ -0,0 +1,64 @@
+#include <stdio.h>
+
+#ifndef HOST_STATS_H
+#define HOST_STATS_H
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Host-side phases that are timed, nested phases are also counted in the phase around them
+typedef enum{
+    HOST_LOAD,          // Whole load command, including cached images and ELF files
+    HOST_LOAD_SCAN,     // Section scan and the source line copy
+    HOST_LOAD_LABELS,   // Label pass of the assembler
+    HOST_LOAD_ENCODE,   // Encoding pass and reading the machine code back
+    HOST_LOAD_DATA,     // .data directives
+    HOST_RUN,           // run, step and the quiet run loop
+    HOST_CACHE,         // Cache model lookups, only timed while cache timing is on
+    HOST_OUTPUT,        // Printing the instruction trace
+    HOST_TIMER_COUNT
+} host_timer;
+
+typedef struct{
+    unsigned long long ticks;
+    long long calls;
+} host_timer_stats;
+
+typedef struct{
+    long long instructions;     // Instructions interpreted on the host
+    long long trace_bytes;      // Bytes of instruction trace written to stdout
+} host_event_stats;
+
+extern host_timer_stats host_timers[HOST_TIMER_COUNT];
+extern host_event_stats host_events;
+extern int host_cache_timing;
+
+// Function to read the host clock, the time stamp counter where there is one and nanoseconds otherwise
+static inline unsigned long long host_ticks(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+// Function to charge the time since start to a phase
+static inline void host_timer_add(host_timer timer, unsigned long long start){
+    host_timers[timer].ticks += host_ticks() - start;
+    host_timers[timer].calls++;
+}
+
+// Function to charge more time to a phase without counting another call
+static inline void host_timer_extend(host_timer timer, unsigned long long start){
+    host_timers[timer].ticks += host_ticks() - start;
+}
+
+void host_stats_init();
+void host_stats_reset();
+void print_host_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include "simulator.h"
+#include "cache.h"
+#include "pipeline.h"
+#include "ooo.h"
+#include "intervals.h"
+
+/*
+Every interval_length retired instructions one line is appended to the interval file:
+index, first instruction, instructions, IPC (- without a timing model), hit rate, misses per kilo-instruction,
+phase and the basic block vector as two hex digits per dimension
+The vector counts instructions per basic block, hashed by the block's first PC into BBV_DIMENSIONS counters
+Phases are found online, an interval joins the nearest phase if its normalized vector is within the threshold
+of that phase's mean vector, otherwise it starts a new phase
+*/
+int intervals_enabled = 0;
+long long interval_length = 0;
+double phase_threshold = PHASE_THRESHOLD;
+FILE* interval_file = NULL;
+
+long long bbv[BBV_DIMENSIONS];
+unsigned block_start_pc = 0;
+long long interval_instructions = 0, interval_index = 0, interval_first = 0;
+long long start_accesses = 0, start_hits = 0, start_misses = 0, start_cycles = 0;
+
+phase_info phases[MAX_PHASES];
+int phase_count = 0, last_phase = -1;
+long long phase_transitions = 0;
+
+// Function to return the cycle count of whichever timing model is on, -1 without one
+long long interval_cycles(){
+    if(ooo_enabled) return core_stats.cycles;
+    if(pipeline_enabled) return pipe_stats.cycles;
+    return -1;
+}
+
+// Function to start counting a new interval from the current counters
+void interval_start(){
+    memset(bbv, 0, sizeof(bbv));
+    interval_instructions = 0;
+    interval_first = instret;
+    start_accesses = cache_accesses;
+    start_hits = cache_hits;
+    start_misses = cache_misses;
+    start_cycles = interval_cycles();
+}
+
+void intervals_reset(){
+    phase_count = 0;
+    last_phase = -1;
+    phase_transitions = 0;
+    interval_index = 0;
+    block_start_pc = TEXT_START;
+    interval_start();
+    if(interval_file) fprintf(interval_file, "# reset\n");
+}
+
+// Function to assign a normalized vector to the nearest phase, or to a new phase if none is close
+int classify_phase(double* vector){
+    int nearest = -1;
+    double nearest_distance = 0;
+    for(int p = 0; p < phase_count; p++){
+        double distance = 0;
+        for(int d = 0; d < BBV_DIMENSIONS; d++) distance += fabs(vector[d] - phases[p].signature[d]);
+        if(nearest < 0 || distance < nearest_distance){
+            nearest = p;
+            nearest_distance = distance;
+        }
+    }
+    if(nearest < 0 || (nearest_distance > phase_threshold && phase_count < MAX_PHASES)){
+        nearest = phase_count++;
+        memset(&phases[nearest], 0, sizeof(phase_info));
+    }
+    // The signature follows the running mean of its intervals
+    phase_info* phase = &phases[nearest];
+    phase->intervals++;
+    for(int d = 0; d < BBV_DIMENSIONS; d++) phase->signature[d] += (vector[d] - phase->signature[d]) / phase->intervals;
+    return nearest;
+}
+
+// Function to end the current interval, classify it and write its line
+void interval_flush(){
+    if(!intervals_enabled || interval_instructions == 0) return;
+    double vector[BBV_DIMENSIONS];
+    char signature[2 * BBV_DIMENSIONS + 1];
+    for(int d = 0; d < BBV_DIMENSIONS; d++){
+        vector[d] = (double)bbv[d] / interval_instructions;
+        sprintf(signature + 2 * d, "%02x", (int)lround(vector[d] * 255));
+    }
+    int phase = classify_phase(vector);
+    if(last_phase >= 0 && phase != last_phase) phase_transitions++;
+    last_phase = phase;
+
+    long long accesses = cache_accesses - start_accesses, hits = cache_hits - start_hits, misses = cache_misses - start_misses;
+    long long cycles = interval_cycles() >= 0 && start_cycles >= 0 ? interval_cycles() - start_cycles : -1;
+    phases[phase].instructions += interval_instructions;
+    phases[phase].accesses += accesses;
+    phases[phase].misses += misses;
+    phases[phase].cycles += cycles > 0 ? cycles : 0;
+
+    char ipc[16] = "-";
+    if(cycles > 0) snprintf(ipc, sizeof(ipc), "%.3f", (double)interval_instructions / cycles);
+    fprintf(interval_file, "%lld %lld %lld %s %.4f %.2f %d %s\n", interval_index++, interval_first, interval_instructions, ipc,
+            accesses ? (double)hits / accesses : 0.0, 1000.0 * misses / interval_instructions, phase, signature);
+    interval_start();
+}
+
+// Function to count a retired instruction into the interval's basic block vector
+void interval_retire(retired_instr* retired){
+    bbv[(block_start_pc / 4 * 2654435761u >> 16) % BBV_DIMENSIONS]++;
+    if(retired->next_pc != retired->pc + 4 || decode_operands(retired->instruction).is_control) block_start_pc = retired->next_pc;
+    if(++interval_instructions == interval_length) interval_flush();
+}
+
+void enable_intervals(long long length, const char* filename, double threshold){
+    if(length < 1 || threshold <= 0){
+        printf("Error: Interval length and phase threshold must be positive\n");
+        return;
+    }
+    FILE* fptr = fopen(filename, "w");
+    if(fptr == NULL){
+        printf("Error: Cannot create interval file %s\n", filename);
+        return;
+    }
+    if(interval_file) fclose(interval_file);
+    interval_file = NULL;
+    interval_length = length;
+    phase_threshold = threshold;
+    intervals_enabled = 1;
+    intervals_reset();
+    interval_file = fptr;
+    fprintf(interval_file, "# interval first_instruction instructions ipc hit_rate mpki phase bbv\n");
+    printf("Interval statistics enabled: every %lld instructions to %s\n", length, filename);
+}
+
+void disable_intervals(){
+    if(intervals_enabled){
+        interval_flush();
+        fclose(interval_file);
+        interval_file = NULL;
+    }
+    intervals_enabled = 0;
+    printf("Interval statistics disabled\n");
+}
+
+void print_interval_stats(){
+    if(!intervals_enabled){
+        printf("Interval statistics are disabled\n");
+        return;
+    }
+    printf("Intervals: %lld (%lld instructions each), %d phases, %lld phase changes\n",
+           interval_index, interval_length, phase_count, phase_transitions);
+    if(phase_count == 0) return;
+    printf("  %-6s %10s %14s %9s %9s %7s\n", "Phase", "Intervals", "Instructions", "Hit rate", "MPKI", "IPC");
+    for(int p = 0; p < phase_count; p++){
+        phase_info* phase = &phases[p];
+        char ipc[16] = "-";
+        if(phase->cycles > 0) snprintf(ipc, sizeof(ipc), "%.3f", (double)phase->instructions / phase->cycles);
+        printf("  %-6d %10lld %14lld %9.4f %9.2f %7s\n", p, phase->intervals, phase->instructions,
+               phase->accesses ? 1 - (double)phase->misses / phase->accesses : 0.0,
+               1000.0 * phase->misses / phase->instructions, ipc);
+    }
+}
\ No newline at end of file
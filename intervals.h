@@ -0,0 +1,29 @@
+#include <stdio.h>
+
+#ifndef INTERVALS_H
+#define INTERVALS_H
+
+#include "simulator.h"
+
+#define BBV_DIMENSIONS 32       // Basic block vectors are hashed down to this many counters
+#define MAX_PHASES 64
+#define PHASE_THRESHOLD 0.4     // Manhattan distance between normalized vectors, 0 to 2, below which an interval joins a phase
+
+typedef struct{
+    double signature[BBV_DIMENSIONS];   // Mean basic block vector of the intervals in the phase
+    long long intervals;
+    long long instructions;
+    long long accesses, misses;
+    long long cycles;
+} phase_info;
+
+extern int intervals_enabled;
+
+void enable_intervals(long long length, const char* filename, double threshold);
+void disable_intervals();
+void intervals_reset();
+void interval_retire(retired_instr* retired);
+void interval_flush();
+void print_interval_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "prefetcher.h"
+#include "miss_classifier.h"
+
+/*
+Every demand access also goes through a shadow fully associative LRU cache with as many lines as the real one
+A miss is compulsory if the block was never referenced before, capacity if the shadow cache misses as well,
+and conflict otherwise. The shadow is a doubly linked recency list over preallocated nodes, and a table
+indexed by block number maps each block to its node, so an access costs a constant number of steps
+*/
+int miss_classifier_enabled = 0;
+long long miss_counts[MISS_KINDS];
+
+long long pc_miss_counts[MAX_INSTRS][MISS_KINDS];
+long long (*set_miss_counts)[MISS_KINDS] = NULL;
+int classified_sets = 0;
+
+unsigned char* touched_blocks = NULL;  // One bit per block of data memory
+int* shadow_node = NULL;                // Node holding each block, -1 if it is not in the shadow cache
+int* shadow_prev = NULL;
+int* shadow_next = NULL;
+int* shadow_block = NULL;               // Block number each node holds
+int shadow_capacity = 0, shadow_used = 0;
+int shadow_head = -1, shadow_tail = -1; // Most and least recently used nodes
+
+// Function to unlink a node from the recency list
+void shadow_unlink(int node){
+    if(shadow_prev[node] >= 0) shadow_next[shadow_prev[node]] = shadow_next[node];
+    else shadow_head = shadow_next[node];
+    if(shadow_next[node] >= 0) shadow_prev[shadow_next[node]] = shadow_prev[node];
+    else shadow_tail = shadow_prev[node];
+}
+
+// Function to make a node the most recently used
+void shadow_push_front(int node){
+    shadow_prev[node] = -1;
+    shadow_next[node] = shadow_head;
+    if(shadow_head >= 0) shadow_prev[shadow_head] = node;
+    shadow_head = node;
+    if(shadow_tail < 0) shadow_tail = node;
+}
+
+// Function to access a block in the shadow cache, returns 1 on a hit
+int shadow_access(int block){
+    int node = shadow_node[block];
+    if(node >= 0){
+        if(node != shadow_head){
+            shadow_unlink(node);
+            shadow_push_front(node);
+        }
+        return 1;
+    }
+    if(shadow_used < shadow_capacity) node = shadow_used++;
+    else{
+        node = shadow_tail;     // The least recently used block makes room
+        shadow_unlink(node);
+        shadow_node[shadow_block[node]] = -1;
+    }
+    shadow_block[node] = block;
+    shadow_node[block] = node;
+    shadow_push_front(node);
+    return 0;
+}
+
+// Function to clear the counters and size the shadow state for the current cache geometry
+void miss_classifier_reset(){
+    memset(miss_counts, 0, sizeof(miss_counts));
+    memset(pc_miss_counts, 0, sizeof(pc_miss_counts));
+    if(!miss_classifier_enabled || cache == NULL) return;
+
+    int blocks = (STACK_START - DATA_START) / block_size;
+    free(touched_blocks);
+    free(shadow_node);
+    free(shadow_prev);
+    free(shadow_next);
+    free(shadow_block);
+    free(set_miss_counts);
+    shadow_capacity = cache->num_sets * cache->lines_per_set;
+    touched_blocks = calloc((blocks + 7) / 8, 1);
+    shadow_node = malloc(blocks * sizeof(int));
+    memset(shadow_node, 0xff, blocks * sizeof(int));    // -1 everywhere
+    shadow_prev = malloc(shadow_capacity * sizeof(int));
+    shadow_next = malloc(shadow_capacity * sizeof(int));
+    shadow_block = malloc(shadow_capacity * sizeof(int));
+    shadow_used = 0;
+    shadow_head = shadow_tail = -1;
+    classified_sets = cache->num_sets;
+    set_miss_counts = calloc(classified_sets, sizeof(*set_miss_counts));
+}
+
+// Function to feed one demand access to the shadow state, a miss of the real cache is classified
+void classify_access(unsigned block_address, int set_index, int missed){
+    if(block_address < DATA_START || block_address >= STACK_START) return;
+    int block = (block_address - DATA_START) / block_size;
+    int first_touch = !(touched_blocks[block / 8] >> (block % 8) & 1);
+    touched_blocks[block / 8] |= 1 << (block % 8);
+    int shadow_hit = shadow_access(block);
+    if(!missed) return;
+
+    miss_kind kind = first_touch ? MISS_COMPULSORY : (shadow_hit ? MISS_CONFLICT : MISS_CAPACITY);
+    miss_counts[kind]++;
+    if(cache_access_pc / 4 < MAX_INSTRS) pc_miss_counts[cache_access_pc / 4][kind]++;
+    if(set_index < classified_sets) set_miss_counts[set_index][kind]++;
+}
+
+void enable_miss_classifier(){
+    if(cache == NULL){
+        printf("Error: Enable the cache with cache_sim enable <file_name> first\n");
+        return;
+    }
+    miss_classifier_enabled = 1;
+    miss_classifier_reset();
+    printf("Miss classification enabled: %d line fully associative shadow cache\n", shadow_capacity);
+}
+
+void disable_miss_classifier(){
+    miss_classifier_enabled = 0;
+    printf("Miss classification disabled\n");
+}
+
+long long (*sort_counts)[MISS_KINDS];     // Table compare_misses() orders by
+
+// Comparison function for qsort, most misses first
+int compare_misses(const void* a, const void* b){
+    long long* x = sort_counts[*(const int*)a];
+    long long* y = sort_counts[*(const int*)b];
+    long long total_x = x[0] + x[1] + x[2], total_y = y[0] + y[1] + y[2];
+    return (total_x < total_y) - (total_x > total_y);
+}
+
+// Function to print the rows of a per-PC or per-set table with the most misses
+void print_top_misses(long long (*counts)[MISS_KINDS], int rows, int top, int by_pc){
+    int* order = malloc(rows * sizeof(int));
+    int used = 0;
+    for(int i = 0; i < rows; i++){
+        if(counts[i][0] + counts[i][1] + counts[i][2] > 0) order[used++] = i;
+    }
+    sort_counts = counts;
+    qsort(order, used, sizeof(int), compare_misses);
+    for(int k = 0; k < used && k < top; k++){
+        int i = order[k];
+        if(by_pc) printf("  0x%08x %-6d %-30s", i * 4, instruction_lines[i], instructions[i]);
+        else printf("  %-8d", i);
+        printf(" %12lld %12lld %12lld\n", counts[i][MISS_COMPULSORY], counts[i][MISS_CAPACITY], counts[i][MISS_CONFLICT]);
+    }
+    free(order);
+}
+
+void print_miss_classes(int top){
+    if(!miss_classifier_enabled){
+        printf("Miss classification is disabled\n");
+        return;
+    }
+    long long total = miss_counts[MISS_COMPULSORY] + miss_counts[MISS_CAPACITY] + miss_counts[MISS_CONFLICT];
+    printf("Miss classes: compulsory %lld (%.2f%%), capacity %lld (%.2f%%), conflict %lld (%.2f%%)\n",
+           miss_counts[MISS_COMPULSORY], total ? 100.0 * miss_counts[MISS_COMPULSORY] / total : 0.0,
+           miss_counts[MISS_CAPACITY], total ? 100.0 * miss_counts[MISS_CAPACITY] / total : 0.0,
+           miss_counts[MISS_CONFLICT], total ? 100.0 * miss_counts[MISS_CONFLICT] / total : 0.0);
+    if(prefetcher_enabled && pf_stats.late) printf("(%lld late prefetches count as misses but are not classified)\n", pf_stats.late);
+    if(total == 0) return;
+
+    printf("Top PCs:\n  %-10s %-6s %-30s %12s %12s %12s\n", "PC", "Line", "Instruction", "Compulsory", "Capacity", "Conflict");
+    print_top_misses(pc_miss_counts, instr_count, top, 1);
+    printf("Top sets:\n  %-8s %12s %12s %12s\n", "Set", "Compulsory", "Capacity", "Conflict");
+    print_top_misses(set_miss_counts, classified_sets, top, 0);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include <stdio.h>
+
+#ifndef MISS_CLASSIFIER_H
+#define MISS_CLASSIFIER_H
+
+#define MISS_TOP 10     // PCs and sets listed by default in the report
+
+typedef enum{
+    MISS_COMPULSORY,    // First reference to the block
+    MISS_CAPACITY,      // Also misses in a fully associative LRU cache of the same size
+    MISS_CONFLICT,      // Would have hit with full associativity
+    MISS_KINDS
+} miss_kind;
+
+extern int miss_classifier_enabled;
+extern long long miss_counts[MISS_KINDS];
+
+void enable_miss_classifier();
+void disable_miss_classifier();
+void miss_classifier_reset();
+void classify_access(unsigned block_address, int set_index, int missed);
+void print_miss_classes(int top);
+
+#endif
\ No newline at end of file
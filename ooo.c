@@ -0,0 +1,295 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "ooo.h"
+#include "dram.h"
+#include "branch_predictor.h"
+
+int ooo_enabled = 0;
+ooo_config core = {4, 128, 48, 32, 1, 3, 100, 3, 20};
+ooo_stats core_stats;
+
+/*
+The engine is a dataflow schedule over the retired instruction stream, the functional simulator already
+knows every outcome so nothing is ever squashed
+Every instruction gets a fetch, dispatch, issue, complete and commit cycle
+Fetch, dispatch and commit are in order and at most fetch_width wide, a taken branch ends a fetch group
+With the branch predictor on, fetch after a mispredicted branch waits until the branch has executed
+Dispatch waits for a free ROB, issue queue and load/store queue entry
+Issue waits for the operands and a free issue slot in that cycle, so independent work overlaps long misses
+*/
+#define FRONTEND_DEPTH 3    // Cycles from fetch to dispatch (decode and rename)
+
+long long issue_ring[OOO_MAX_WINDOW];      // Issue cycle of the last OOO_MAX_WINDOW instructions
+long long commit_ring[OOO_MAX_WINDOW];     // Commit cycle of the last OOO_MAX_WINDOW instructions
+long long mem_commit_ring[OOO_MAX_WINDOW]; // Commit cycle of the last OOO_MAX_WINDOW loads and stores
+long long mem_op_count = 0;
+long long ready_cycle[32];                 // Cycle in which each register value becomes available
+
+long long slot_cycle[OOO_ISSUE_SLOTS];     // Cycle a slot currently counts for
+int slot_used[OOO_ISSUE_SLOTS];            // Instructions issued in that cycle
+
+long long fetch_cycle, fetch_used;         // Current fetch cycle and instructions fetched in it
+long long dispatch_cycle, dispatch_used;
+long long commit_cycle, commit_used;
+int fetch_redirect = 0;                    // 1 if the previous instruction was a taken branch or jump
+long long resteer_cycle = 0;               // First cycle fetch may continue after a mispredict
+
+typedef struct{
+    long long start, end;                  // Cycles a missing load is outstanding
+} miss_interval;
+/*
+Misses issue out of order, but never before the dispatch cycle of the newest instruction, so a miss
+that starts at or before it can no longer be overtaken and is folded into the running totals
+At most iq_size of them are still waiting to issue, which bounds the heap
+*/
+miss_interval pending_misses[OOO_MAX_WINDOW];   // Min-heap on the first cycle
+int pending_count = 0;
+long long miss_cycles = 0, miss_busy_cycles = 0;    // Cycles summed over misses, and cycles with at least one
+long long covered_until = 0;                        // Last cycle of the busy time counted so far
+
+// Function to read the core parameters, one per line in the order of ooo_config
+int read_ooo_config(char* config_file, ooo_config* config){
+    FILE* fptr = fopen(config_file, "r");
+    if(fptr == NULL){
+        perror("Error opening file");
+        return 0;
+    }
+    char buffer[50];
+    int line_num = 0;
+    int* fields[9] = {&config->fetch_width, &config->rob_size, &config->iq_size, &config->lsq_size,
+                      &config->alu_latency, &config->hit_latency, &config->memory_latency,
+                      &config->mul_latency, &config->div_latency};
+
+    while(fgets(buffer, sizeof(buffer), fptr)){
+        buffer[strcspn(buffer, "\n")] = 0;
+        if(line_num < 9) *fields[line_num] = atoi(buffer);
+        else if(buffer[0] != '\0') printf("Unexpected line in configuration file\n");
+        line_num++;
+    }
+    fclose(fptr);
+    if(config->fetch_width < 1 || config->rob_size < 1 || config->rob_size > OOO_MAX_WINDOW ||
+       config->iq_size < 1 || config->iq_size > OOO_MAX_WINDOW || config->lsq_size < 1 || config->lsq_size > OOO_MAX_WINDOW ||
+       config->alu_latency < 1 || config->hit_latency < 1 || config->memory_latency < 0 ||
+       config->mul_latency < 1 || config->div_latency < 1){
+        printf("Error: Invalid core configuration in %s (window sizes go up to %d)\n", config_file, OOO_MAX_WINDOW);
+        return 0;
+    }
+    return 1;
+}
+
+// Function to switch the out-of-order engine on, the parameters stay at their defaults without a config file
+void enable_ooo(char* config_file){
+    ooo_config config = {4, 128, 48, 32, 1, 3, 100, 3, 20};
+    if(config_file != NULL && !read_ooo_config(config_file, &config)) return;
+    core = config;
+    ooo_enabled = 1;
+    ooo_reset();
+    printf("Out-of-order model enabled (width %d, ROB %d, IQ %d, LSQ %d, ALU latency %d, hit latency %d, memory latency %d, "
+           "mul latency %d, div latency %d)\n", core.fetch_width, core.rob_size, core.iq_size, core.lsq_size, core.alu_latency,
+           core.hit_latency, core.memory_latency, core.mul_latency, core.div_latency);
+}
+
+// Function to switch the out-of-order engine off
+void disable_ooo(){
+    ooo_enabled = 0;
+    printf("Out-of-order model disabled\n");
+}
+
+// Function to clear the schedule and the statistics
+void ooo_reset(){
+    memset(&core_stats, 0, sizeof(core_stats));
+    memset(issue_ring, 0, sizeof(issue_ring));
+    memset(commit_ring, 0, sizeof(commit_ring));
+    memset(mem_commit_ring, 0, sizeof(mem_commit_ring));
+    memset(ready_cycle, 0, sizeof(ready_cycle));
+    memset(slot_cycle, -1, sizeof(slot_cycle));
+    memset(slot_used, 0, sizeof(slot_used));
+    mem_op_count = 0;
+    fetch_cycle = fetch_used = 0;
+    dispatch_cycle = dispatch_used = 0;
+    commit_cycle = commit_used = 0;
+    fetch_redirect = 0;
+    resteer_cycle = 0;
+    pending_count = 0;
+    miss_cycles = miss_busy_cycles = covered_until = 0;
+}
+
+// Function to remove the earliest pending miss from the heap
+miss_interval pop_pending_miss(){
+    miss_interval first = pending_misses[0];
+    miss_interval last = pending_misses[--pending_count];
+    int i = 0;
+    while(2 * i + 1 < pending_count){
+        int child = 2 * i + 1;
+        if(child + 1 < pending_count && pending_misses[child + 1].start < pending_misses[child].start) child++;
+        if(last.start <= pending_misses[child].start) break;
+        pending_misses[i] = pending_misses[child];
+        i = child;
+    }
+    if(pending_count > 0) pending_misses[i] = last;
+    return first;
+}
+
+// Function to add a miss, in order of its first cycle, to the busy time
+void account_miss(miss_interval miss, long long* busy, long long* until){
+    long long start = miss.start > *until ? miss.start : *until;
+    if(miss.end > start){
+        *busy += miss.end - start;
+        *until = miss.end;
+    }
+}
+
+// Function to fold every pending miss that starts before the given cycle into the totals
+void settle_misses(long long before){
+    while(pending_count > 0 && pending_misses[0].start < before){
+        account_miss(pop_pending_miss(), &miss_busy_cycles, &covered_until);
+    }
+}
+
+// Function to add an outstanding miss to the heap
+void push_pending_miss(long long start, long long end){
+    if(pending_count == OOO_MAX_WINDOW) account_miss(pop_pending_miss(), &miss_busy_cycles, &covered_until);
+    int i = pending_count++;
+    while(i > 0 && pending_misses[(i - 1) / 2].start > start){
+        pending_misses[i] = pending_misses[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    pending_misses[i].start = start;
+    pending_misses[i].end = end;
+    miss_cycles += end - start;
+}
+
+// Function to move an in-order stage to the given cycle and take one of its slots
+long long take_in_order_slot(long long* cycle, long long* used, long long earliest){
+    if(earliest > *cycle){
+        *cycle = earliest;
+        *used = 0;
+    }
+    if(*used == core.fetch_width){
+        (*cycle)++;
+        *used = 0;
+    }
+    (*used)++;
+    return *cycle;
+}
+
+// Function to find the first cycle from earliest with a free issue slot and take it
+long long take_issue_slot(long long earliest){
+    for(long long cycle = earliest; ; cycle++){
+        int slot = cycle % OOO_ISSUE_SLOTS;
+        if(slot_cycle[slot] != cycle){
+            slot_cycle[slot] = cycle;
+            slot_used[slot] = 0;
+        }
+        if(slot_used[slot] < core.fetch_width){
+            slot_used[slot]++;
+            return cycle;
+        }
+    }
+}
+
+// Function to schedule one retired instruction
+void ooo_retire(retired_instr* retired){
+    instr_info info = decode_operands(retired->instruction);
+    long long index = core_stats.instructions;
+    int is_memory = info.is_load || info.is_store;
+
+    long long earliest_fetch = fetch_redirect ? fetch_cycle + 1 : fetch_cycle;
+    if(resteer_cycle > earliest_fetch) earliest_fetch = resteer_cycle;
+    earliest_fetch += retired->itlb_cycles;
+    long long fetched = take_in_order_slot(&fetch_cycle, &fetch_used, earliest_fetch);
+    fetch_redirect = retired->next_pc != retired->pc + 4;
+
+    // Every window resource sets a floor on dispatch, stalls go to the first resource that raised it
+    long long dispatch = fetched + FRONTEND_DEPTH;
+    if(dispatch < dispatch_cycle) dispatch = dispatch_cycle;
+    if(index >= core.rob_size){
+        long long freed = commit_ring[(index - core.rob_size) % OOO_MAX_WINDOW] + 1;
+        if(freed > dispatch){
+            core_stats.rob_stalls += freed - dispatch;
+            dispatch = freed;
+        }
+    }
+    if(index >= core.iq_size){
+        long long freed = issue_ring[(index - core.iq_size) % OOO_MAX_WINDOW] + 1;
+        if(freed > dispatch){
+            core_stats.iq_stalls += freed - dispatch;
+            dispatch = freed;
+        }
+    }
+    if(is_memory && mem_op_count >= core.lsq_size){
+        long long freed = mem_commit_ring[(mem_op_count - core.lsq_size) % OOO_MAX_WINDOW] + 1;
+        if(freed > dispatch){
+            core_stats.lsq_stalls += freed - dispatch;
+            dispatch = freed;
+        }
+    }
+    dispatch = take_in_order_slot(&dispatch_cycle, &dispatch_used, dispatch);
+    settle_misses(dispatch + 1);    // This and every later instruction issues after dispatch
+
+    long long operands = dispatch + 1;
+    if(info.rs1 != 0 && ready_cycle[info.rs1] > operands) operands = ready_cycle[info.rs1];
+    if(info.rs2 != 0 && ready_cycle[info.rs2] > operands) operands = ready_cycle[info.rs2];
+    long long issue = take_issue_slot(operands);
+
+    // Stores only compute their address before commit, the data is written to the cache afterwards
+    int latency = core.alu_latency;
+    if(info.is_multiply) latency = core.mul_latency;
+    else if(info.is_divide) latency = core.div_latency;
+    else if(info.is_load){
+        latency = core.hit_latency + (dram_enabled ? retired->memory_cycles : retired->cache_misses * core.memory_latency);
+        latency += retired->dtlb_cycles;
+        core_stats.loads++;
+        core_stats.load_misses += retired->cache_misses;
+        if(retired->cache_misses > 0) push_pending_miss(issue, issue + latency);
+    }
+    else if(info.is_store) core_stats.stores++;
+    long long complete = issue + latency;
+    if(info.rd != 0) ready_cycle[info.rd] = complete;
+    if(branch_predictor_enabled && retired->mispredicted){
+        resteer_cycle = complete + 1;
+        core_stats.mispredicts++;
+    }
+
+    long long commit = take_in_order_slot(&commit_cycle, &commit_used, complete + 1);
+    issue_ring[index % OOO_MAX_WINDOW] = issue;
+    commit_ring[index % OOO_MAX_WINDOW] = commit;
+    if(is_memory) mem_commit_ring[mem_op_count++ % OOO_MAX_WINDOW] = commit;
+
+    core_stats.instructions++;
+    core_stats.cycles = commit + 1;
+}
+
+// Function to compute the average number of outstanding misses over the cycles with at least one
+double memory_level_parallelism(){
+    // The pending misses are taken in order from a copy so reporting leaves the heap alone
+    miss_interval saved[OOO_MAX_WINDOW];
+    int saved_count = pending_count;
+    memcpy(saved, pending_misses, pending_count * sizeof(miss_interval));
+    long long busy = miss_busy_cycles, until = covered_until;
+    while(pending_count > 0) account_miss(pop_pending_miss(), &busy, &until);
+    memcpy(pending_misses, saved, saved_count * sizeof(miss_interval));
+    pending_count = saved_count;
+    return busy ? (double)miss_cycles / busy : 0;
+}
+
+// Function to print IPC, the dispatch stalls and the memory-level parallelism
+void print_ooo_stats(){
+    if(!ooo_enabled){
+        printf("Out-of-order model is disabled\n");
+        return;
+    }
+    if(core_stats.instructions == 0){
+        printf("No instructions went through the out-of-order model yet\n");
+        return;
+    }
+    printf("OoO cycles: %lld, instructions: %lld, IPC: %.3f\n",
+           core_stats.cycles, core_stats.instructions, (double)core_stats.instructions / core_stats.cycles);
+    printf("Dispatch stall cycles: ROB full %lld, IQ full %lld, LSQ full %lld\n",
+           core_stats.rob_stalls, core_stats.iq_stalls, core_stats.lsq_stalls);
+    printf("Loads: %lld, stores: %lld, load misses: %lld, MLP: %.2f\n",
+           core_stats.loads, core_stats.stores, core_stats.load_misses, memory_level_parallelism());
+    if(branch_predictor_enabled) printf("Mispredicted branches and jumps: %lld\n", core_stats.mispredicts);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include <stdio.h>
+
+#ifndef OOO_H
+#define OOO_H
+
+#include "simulator.h"
+
+#define OOO_MAX_WINDOW 1024     // Upper bound for the ROB, issue queue and load/store queue sizes
+#define OOO_ISSUE_SLOTS 4096    // Cycles tracked at once for the issue width limit
+
+typedef struct{
+    int fetch_width;        // Instructions fetched, dispatched, issued and committed per cycle
+    int rob_size;
+    int iq_size;            // Issue queue entries, freed when an instruction issues
+    int lsq_size;           // Load/store queue entries, freed when a load or store commits
+    int alu_latency;
+    int hit_latency;        // Load latency on a cache hit
+    int memory_latency;     // Extra load latency for every cache miss
+    int mul_latency;        // RV64M multiplies
+    int div_latency;        // RV64M divides and remainders
+} ooo_config;
+
+typedef struct{
+    long long instructions;
+    long long cycles;
+    long long rob_stalls;       // Dispatch cycles lost to a full ROB
+    long long iq_stalls;        // Dispatch cycles lost to a full issue queue
+    long long lsq_stalls;       // Dispatch cycles lost to a full load/store queue
+    long long loads;
+    long long stores;
+    long long load_misses;
+    long long mispredicts;      // Only counted with the branch predictor on
+} ooo_stats;
+
+extern int ooo_enabled;
+extern ooo_stats core_stats;
+extern long long dispatch_cycle;
+
+void enable_ooo(char* config_file);
+void disable_ooo();
+void ooo_reset();
+void ooo_retire(retired_instr* retired);
+void print_ooo_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "pipeline.h"
+#include "dram.h"
+
+int pipeline_enabled = 0;
+pipeline_config pipe_config = {1, 2, 1, 100};
+pipeline_stats pipe_stats;
+
+/*
+The model does not keep pipeline registers, it tracks the cycle in which every instruction is in EX
+IF and ID of the first instruction take cycles 0 and 1, every later instruction follows one cycle
+behind the previous one unless a hazard pushes it back
+*/
+long long last_ex = -1;             // EX cycle of the previous instruction, -1 before the first one
+int last_mem_cycles = 1;            // Cycles the previous instruction spent in MEM
+int last_mispredicted = 0;          // 1 if fetch went down the wrong path after the previous instruction
+long long reg_ready[32];            // First cycle a consumer of each register may be in EX
+int reg_from_load[32];              // 1 if the pending value of the register comes from a load
+
+// Function to read the pipeline parameters, one per line in the order of pipeline_config
+int read_pipeline_config(char* config_file, pipeline_config* config){
+    FILE* fptr = fopen(config_file, "r");
+    if(fptr == NULL){
+        perror("Error opening file");
+        return 0;
+    }
+    char buffer[50];
+    int line_num = 0;
+    int* fields[4] = {&config->forwarding, &config->branch_penalty, &config->hit_latency, &config->memory_latency};
+
+    while(fgets(buffer, sizeof(buffer), fptr)){
+        buffer[strcspn(buffer, "\n")] = 0;
+        if(line_num < 4) *fields[line_num] = atoi(buffer);
+        else if(buffer[0] != '\0') printf("Unexpected line in configuration file\n");
+        line_num++;
+    }
+    fclose(fptr);
+    if(config->branch_penalty < 0 || config->hit_latency < 1 || config->memory_latency < 0){
+        printf("Error: Invalid pipeline configuration in %s\n", config_file);
+        return 0;
+    }
+    return 1;
+}
+
+// Function to switch the timing model on, the parameters stay at their defaults without a config file
+void enable_pipeline(char* config_file){
+    pipeline_config config = {1, 2, 1, 100};
+    if(config_file != NULL && !read_pipeline_config(config_file, &config)) return;
+    pipe_config = config;
+    pipeline_enabled = 1;
+    pipeline_reset();
+    printf("Pipeline model enabled (forwarding %s, branch penalty %d, hit latency %d, memory latency %d)\n",
+           pipe_config.forwarding ? "on" : "off", pipe_config.branch_penalty, pipe_config.hit_latency, pipe_config.memory_latency);
+}
+
+// Function to switch the timing model off
+void disable_pipeline(){
+    pipeline_enabled = 0;
+    printf("Pipeline model disabled\n");
+}
+
+// Function to clear the timing state and the statistics
+void pipeline_reset(){
+    memset(&pipe_stats, 0, sizeof(pipe_stats));
+    memset(reg_ready, 0, sizeof(reg_ready));
+    memset(reg_from_load, 0, sizeof(reg_from_load));
+    last_ex = -1;
+    last_mem_cycles = 1;
+    last_mispredicted = 0;
+}
+
+// Function to place one executed instruction into the pipeline schedule
+void pipeline_retire(retired_instr* retired){
+    instr_info info = decode_operands(retired->instruction);
+    int mem_cycles = 1;
+    if(info.is_load || info.is_store){
+        // The DRAM model replaces the fixed miss latency with the time each miss actually waited
+        mem_cycles = pipe_config.hit_latency + (dram_enabled ? retired->memory_cycles : retired->cache_misses * pipe_config.memory_latency);
+        mem_cycles += retired->dtlb_cycles;
+        pipe_stats.memory_ops++;
+        pipe_stats.memory_misses += retired->cache_misses;
+    }
+
+    // Every hazard sets a floor on the EX cycle, stalls go to the first cause that raised it
+    long long ex = (last_ex < 0) ? 2 : last_ex + 1;
+    if(retired->itlb_cycles > 0){   // An ITLB miss holds up fetch
+        pipe_stats.memory_stalls += retired->itlb_cycles;
+        ex += retired->itlb_cycles;
+    }
+    if(last_ex >= 0 && last_ex + last_mem_cycles > ex){
+        pipe_stats.memory_stalls += last_ex + last_mem_cycles - ex;
+        ex = last_ex + last_mem_cycles;
+    }
+    if(last_mispredicted && last_ex + 1 + pipe_config.branch_penalty > ex){
+        pipe_stats.control_stalls += last_ex + 1 + pipe_config.branch_penalty - ex;
+        ex = last_ex + 1 + pipe_config.branch_penalty;
+    }
+    int sources[2] = {info.rs1, info.rs2};
+    for(int i = 0; i < 2; i++){
+        int reg = sources[i];
+        if(reg == 0 || reg_ready[reg] <= ex) continue;
+        if(reg_from_load[reg]) pipe_stats.load_use_stalls += reg_ready[reg] - ex;
+        else pipe_stats.data_stalls += reg_ready[reg] - ex;
+        ex = reg_ready[reg];
+    }
+
+    if(info.rd != 0){
+        // Results leave EX (or MEM for loads) a cycle before a dependent EX, without forwarding they go through WB and ID
+        long long produced = info.is_load ? ex + mem_cycles : ex;
+        reg_ready[info.rd] = pipe_config.forwarding ? produced + 1 : ex + mem_cycles + 2;
+        reg_from_load[info.rd] = info.is_load;
+    }
+
+    last_ex = ex;
+    last_mem_cycles = mem_cycles;
+    last_mispredicted = retired->mispredicted;
+    pipe_stats.instructions++;
+    pipe_stats.cycles = ex + mem_cycles + 2;    // The last instruction still has to finish MEM and WB
+}
+
+// Function to print cycles, CPI, the stall breakdown and the average memory access time
+void print_pipeline_stats(){
+    if(!pipeline_enabled){
+        printf("Pipeline model is disabled\n");
+        return;
+    }
+    if(pipe_stats.instructions == 0){
+        printf("No instructions went through the pipeline model yet\n");
+        return;
+    }
+    long long stalls = pipe_stats.memory_stalls + pipe_stats.control_stalls + pipe_stats.load_use_stalls + pipe_stats.data_stalls;
+    printf("Pipeline cycles: %lld, instructions: %lld, CPI: %.3f\n",
+           pipe_stats.cycles, pipe_stats.instructions, (double)pipe_stats.cycles / pipe_stats.instructions);
+    printf("Stall cycles: %lld (memory %lld, control %lld, load-use %lld, data %lld)\n", stalls,
+           pipe_stats.memory_stalls, pipe_stats.control_stalls, pipe_stats.load_use_stalls, pipe_stats.data_stalls);
+    if(pipe_stats.memory_ops > 0){
+        double miss_rate = (double)pipe_stats.memory_misses / pipe_stats.memory_ops;
+        if(dram_enabled && mem_stats.demand_reads > 0){
+            // Misses pay what the DRAM model measured rather than the configured latency
+            double miss_latency = (double)mem_stats.demand_latency / mem_stats.demand_reads;
+            printf("AMAT: %.2f cycles (hit latency %d + miss rate %.4f x average DRAM latency %.2f)\n",
+                   pipe_config.hit_latency + miss_rate * miss_latency, pipe_config.hit_latency, miss_rate, miss_latency);
+        }
+        else printf("AMAT: %.2f cycles (hit latency %d + miss rate %.4f x memory latency %d)\n",
+                    pipe_config.hit_latency + miss_rate * pipe_config.memory_latency, pipe_config.hit_latency, miss_rate, pipe_config.memory_latency);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include <stdio.h>
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "simulator.h"
+
+typedef struct{
+    int forwarding;         // 1 if EX and MEM results are bypassed to EX
+    int branch_penalty;     // Cycles lost when a taken branch or jump resolves in EX
+    int hit_latency;        // Cycles a load or store spends in MEM on a cache hit
+    int memory_latency;     // Extra cycles for every cache miss
+} pipeline_config;
+
+typedef struct{
+    long long cycles;
+    long long instructions;
+    long long memory_stalls;     // Waiting for a slow MEM stage ahead
+    long long control_stalls;    // Taken branches and jumps
+    long long load_use_stalls;   // Waiting on a value produced by a load
+    long long data_stalls;       // Waiting on any other value
+    long long memory_ops;
+    long long memory_misses;
+} pipeline_stats;
+
+extern int pipeline_enabled;
+extern pipeline_stats pipe_stats;
+
+void enable_pipeline(char* config_file);
+void disable_pipeline();
+void pipeline_reset();
+void pipeline_retire(retired_instr* retired);
+void print_pipeline_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "cache.h"
+#include "prefetcher.h"
+
+/*
+The prefetchers only decide which blocks to fetch, cache.c fills them through prefetch_block()
+Every demand access trains the PC-based prefetchers, next-line and stream prefetching are triggered
+by demand misses and by the first demand hit on a prefetched block so a covered stream keeps going
+*/
+int prefetcher_enabled = 0;
+prefetch_config prefetch_settings = {PREFETCH_NEXT_LINE, 2, 1, 8};
+prefetch_stats pf_stats;
+
+typedef struct{
+    unsigned pc;
+    unsigned last_address;
+    int stride;
+    int confidence;         // 2-bit, prefetches are issued from 2 up
+} rpt_entry;
+
+typedef struct{
+    int valid;
+    long long head;         // Last block the stream was confirmed at
+    int direction;          // 1 or -1, 0 until the second miss shows the direction
+    int last_use;
+} stream_tracker;
+
+typedef struct{
+    unsigned pc;
+    long long last_block;
+    int count;
+    int deltas[DELTA_HISTORY];  // Oldest first
+} delta_entry;
+
+rpt_entry rpt[RPT_ENTRIES];
+stream_tracker streams[STREAM_TRACKERS];
+delta_entry delta_table[DELTA_ENTRIES];
+unsigned pollution_filter[POLLUTION_FILTER];   // Block address + 1, 0 for an empty slot
+int stream_clock = 0;
+
+// Function to clear the prefetcher tables and statistics
+void prefetcher_reset(){
+    memset(rpt, 0, sizeof(rpt));
+    memset(streams, 0, sizeof(streams));
+    memset(delta_table, 0, sizeof(delta_table));
+    memset(pollution_filter, 0, sizeof(pollution_filter));
+    memset(&pf_stats, 0, sizeof(pf_stats));
+    stream_clock = 0;
+}
+
+// Function to remember a block a prefetch pushed out of the cache
+void prefetch_note_victim(unsigned block_address){
+    pollution_filter[(block_address / block_size) % POLLUTION_FILTER] = block_address + 1;
+}
+
+// Function to count a demand miss on a block that a prefetch evicted
+void prefetch_check_pollution(unsigned block_address){
+    unsigned* slot = &pollution_filter[(block_address / block_size) % POLLUTION_FILTER];
+    if(*slot == block_address + 1){
+        pf_stats.pollution++;
+        *slot = 0;
+    }
+}
+
+// Function to prefetch degree blocks starting distance blocks away in one direction
+void prefetch_run(long long block, int direction){
+    for(int i = 0; i < prefetch_settings.degree; i++){
+        long long target = block + direction * (long long)(prefetch_settings.distance + i);
+        if(target >= 0) prefetch_block((unsigned)(target * block_size));
+    }
+}
+
+// Function to train the stride table and prefetch along a confirmed stride
+void stride_access(unsigned pc, unsigned address){
+    rpt_entry* entry = &rpt[(pc >> 2) % RPT_ENTRIES];
+    if(entry->pc != pc){
+        entry->pc = pc;
+        entry->last_address = address;
+        entry->stride = 0;
+        entry->confidence = 0;
+        return;
+    }
+    int stride = (int)(address - entry->last_address);
+    if(stride == entry->stride){
+        if(entry->confidence < 3) entry->confidence++;
+    }
+    else if(entry->confidence > 0) entry->confidence--;
+    else entry->stride = stride;
+    entry->last_address = address;
+    if(entry->confidence < 2 || entry->stride == 0) return;
+
+    unsigned last_block = address / block_size;
+    for(int i = 0; i < prefetch_settings.degree; i++){
+        unsigned target = address + entry->stride * (prefetch_settings.distance + i);
+        if(target / block_size == last_block) continue;     // Strides smaller than a block share blocks
+        last_block = target / block_size;
+        prefetch_block(target);
+    }
+}
+
+// Function to follow miss streams and run ahead of the ones that are confirmed
+void stream_access(long long block){
+    stream_clock++;
+    int window = prefetch_settings.distance + prefetch_settings.degree;
+    stream_tracker* oldest = &streams[0];
+    for(int i = 0; i < STREAM_TRACKERS; i++){
+        stream_tracker* s = &streams[i];
+        if(!s->valid){
+            if(oldest->valid) oldest = s;
+            continue;
+        }
+        long long step = block - s->head;
+        int matched = s->direction != 0 ? step * s->direction >= 1 && step * s->direction <= window
+                                        : (step == 1 || step == -1 || step == 2 || step == -2);
+        if(matched){
+            if(s->direction == 0) s->direction = step > 0 ? 1 : -1;
+            s->head = block;
+            s->last_use = stream_clock;
+            prefetch_run(block, s->direction);
+            return;
+        }
+        if(oldest->valid && s->last_use < oldest->last_use) oldest = s;
+    }
+    oldest->valid = 1;      // A new stream, its direction is known from its next miss
+    oldest->head = block;
+    oldest->direction = 0;
+    oldest->last_use = stream_clock;
+}
+
+// Function to record the delta history of a PC and replay the deltas that followed the last pair before
+void delta_access(unsigned pc, long long block){
+    delta_entry* entry = &delta_table[(pc >> 2) % DELTA_ENTRIES];
+    if(entry->pc != pc){
+        memset(entry, 0, sizeof(delta_entry));
+        entry->pc = pc;
+        entry->last_block = block;
+        return;
+    }
+    long long delta = block - entry->last_block;
+    if(delta == 0) return;
+    entry->last_block = block;
+    if(entry->count == DELTA_HISTORY){
+        memmove(entry->deltas, entry->deltas + 1, (DELTA_HISTORY - 1) * sizeof(int));
+        entry->count--;
+    }
+    entry->deltas[entry->count++] = (int)delta;
+    if(entry->count < 3) return;
+
+    // Searching backwards for an earlier occurrence of the two newest deltas
+    int n = entry->count;
+    int match = -1;
+    for(int i = n - 2; i >= 1; i--){
+        if(entry->deltas[i - 1] == entry->deltas[n - 2] && entry->deltas[i] == entry->deltas[n - 1]){
+            match = i;
+            break;
+        }
+    }
+    if(match < 0) return;
+    long long target = block;
+    int replayed = 0, step = 0;
+    for(int j = match + 1; replayed < prefetch_settings.degree; j++){
+        if(j == n) j = match + 1;   // The pattern repeats, keep replaying it
+        target += entry->deltas[j];
+        if(++step < prefetch_settings.distance) continue;
+        if(target >= 0) prefetch_block((unsigned)(target * block_size));
+        replayed++;
+    }
+}
+
+// Function called after every demand access, trigger is set for misses and first hits on prefetched blocks
+void prefetch_access(unsigned pc, unsigned address, int trigger){
+    long long block = address / block_size;
+    if(prefetch_settings.kind == PREFETCH_STRIDE) stride_access(pc, address);
+    else if(prefetch_settings.kind == PREFETCH_DELTA) delta_access(pc, block);
+    else if(trigger && prefetch_settings.kind == PREFETCH_NEXT_LINE) prefetch_run(block, 1);
+    else if(trigger) stream_access(block);
+}
+
+void enable_prefetcher(const char* kind, int degree, int distance, int latency){
+    prefetcher_kind selected;
+    if(strcmp(kind, "nextline") == 0) selected = PREFETCH_NEXT_LINE;
+    else if(strcmp(kind, "stride") == 0) selected = PREFETCH_STRIDE;
+    else if(strcmp(kind, "stream") == 0) selected = PREFETCH_STREAM;
+    else if(strcmp(kind, "delta") == 0) selected = PREFETCH_DELTA;
+    else{
+        printf("Error: Unknown prefetcher %s (nextline, stride, stream or delta)\n", kind);
+        return;
+    }
+    if(degree < 1 || degree > 16 || distance < 1 || distance > 64 || latency < 0){
+        printf("Error: Degree must be 1 to 16, distance 1 to 64 and latency not negative\n");
+        return;
+    }
+    prefetch_settings.kind = selected;
+    prefetch_settings.degree = degree;
+    prefetch_settings.distance = distance;
+    prefetch_settings.latency = latency;
+    prefetcher_reset();
+    prefetcher_enabled = 1;
+    printf("Prefetcher enabled: %s, degree %d, distance %d, latency %d accesses\n", kind, degree, distance, latency);
+}
+
+void disable_prefetcher(){
+    prefetcher_enabled = 0;
+    printf("Prefetcher disabled\n");
+}
+
+void print_prefetch_stats(){
+    if(!prefetcher_enabled){
+        printf("Prefetcher is disabled\n");
+        return;
+    }
+    printf("Prefetches issued: %lld, useful: %lld (accuracy %.2f%%), late: %lld\n", pf_stats.issued, pf_stats.useful,
+           pf_stats.issued ? 100.0 * pf_stats.useful / pf_stats.issued : 0.0, pf_stats.late);
+    printf("Unused prefetches evicted: %lld, pollution misses: %lld\n", pf_stats.unused, pf_stats.pollution);
+    long long covered = pf_stats.useful - pf_stats.late;
+    long long uncovered = cache_misses - pf_stats.late;     // Demand misses no prefetch hid
+    printf("Coverage: %.2f%% of would-be misses\n", covered + uncovered ? 100.0 * covered / (covered + uncovered) : 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include <stdio.h>
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#define RPT_ENTRIES 64          // PC-indexed reference prediction table of the stride prefetcher
+#define STREAM_TRACKERS 8       // Streams followed at once by the stream prefetcher
+#define DELTA_ENTRIES 64        // PCs tracked by the delta-correlation prefetcher
+#define DELTA_HISTORY 16        // Block deltas remembered per PC
+#define POLLUTION_FILTER 1024   // Blocks recently evicted by prefetches
+
+typedef enum{
+    PREFETCH_NEXT_LINE,     // The blocks after a miss or a first hit on a prefetched block
+    PREFETCH_STRIDE,        // Constant strides per load or store PC
+    PREFETCH_STREAM,        // Ascending or descending miss streams
+    PREFETCH_DELTA          // Repeating patterns of block deltas per PC
+} prefetcher_kind;
+
+typedef struct{
+    prefetcher_kind kind;
+    int degree;             // Blocks prefetched per trigger
+    int distance;           // How far ahead of the access the first prefetch lands, in blocks or strides
+    int latency;            // Cache accesses before a prefetched block arrives
+} prefetch_config;
+
+typedef struct{
+    long long issued;       // Blocks brought in by prefetches
+    long long useful;       // Prefetched blocks later hit by a demand access
+    long long late;         // Useful prefetches that had not arrived yet, they still cost a miss
+    long long unused;       // Prefetched blocks evicted before any demand access
+    long long pollution;    // Demand misses on blocks a prefetch had evicted
+} prefetch_stats;
+
+extern int prefetcher_enabled;
+extern prefetch_config prefetch_settings;
+extern prefetch_stats pf_stats;
+
+void enable_prefetcher(const char* kind, int degree, int distance, int latency);
+void disable_prefetcher();
+void prefetcher_reset();
+void prefetch_access(unsigned pc, unsigned address, int trigger);
+void prefetch_note_victim(unsigned block_address);
+void prefetch_check_pollution(unsigned block_address);
+void print_prefetch_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "profiler.h"
+
+int profiling_enabled = 0;
+
+// Per-instruction counters indexed by pc/4, updated with plain increments while profiling
+unsigned long long pc_executions[MAX_INSTRS];
+unsigned long long pc_taken[MAX_INSTRS];
+unsigned long long pc_memory_ops[MAX_INSTRS];
+unsigned long long pc_cache_hits[MAX_INSTRS];
+unsigned long long pc_cache_misses[MAX_INSTRS];
+
+// Per-function call graph counters indexed by label ID + 1, slot 0 is the main frame
+unsigned long long function_calls[MAX_LABELS + 1];
+unsigned long long function_inclusive[MAX_LABELS + 1];
+unsigned long long function_exclusive[MAX_LABELS + 1];
+unsigned long long function_inclusive_misses[MAX_LABELS + 1];
+unsigned long long function_exclusive_misses[MAX_LABELS + 1];
+int function_active[MAX_LABELS + 1];   // Frames of the function on the stack, inclusive counts are taken at the outermost
+long long profiled_instructions = 0, profiled_misses = 0;
+
+// Function to start the inclusive counts of the frames already on the stack
+void enter_open_frames(){
+    memset(function_active, 0, sizeof(function_active));
+    for(int i = 0; i <= stack_top; i++){
+        call_stack[i].entry_instructions = profiled_instructions;
+        call_stack[i].entry_misses = profiled_misses;
+        function_active[call_stack[i].label_id + 1]++;
+    }
+}
+
+// Function to end the inclusive counts of the frames on the stack when profiling pauses
+void leave_open_frames(){
+    for(int i = 0; i <= stack_top; i++){
+        int function = call_stack[i].label_id + 1;
+        if(function_active[function] == 0) continue;    // Counted at an outer frame already
+        function_inclusive[function] += profiled_instructions - call_stack[i].entry_instructions;
+        function_inclusive_misses[function] += profiled_misses - call_stack[i].entry_misses;
+        function_active[function] = 0;
+    }
+}
+
+// Function to switch profiling on, counters from an earlier profile are kept until the next load
+void enable_profiling(){
+    profiling_enabled = 1;
+    enter_open_frames();
+    printf("Profiling enabled\n");
+}
+
+// Function to switch profiling off, the open frames keep what they counted so far
+void disable_profiling(){
+    if(profiling_enabled) leave_open_frames();
+    profiling_enabled = 0;
+    printf("Profiling disabled\n");
+}
+
+// Function to clear every counter
+void profile_reset(){
+    memset(pc_executions, 0, sizeof(pc_executions));
+    memset(pc_taken, 0, sizeof(pc_taken));
+    memset(pc_memory_ops, 0, sizeof(pc_memory_ops));
+    memset(pc_cache_hits, 0, sizeof(pc_cache_hits));
+    memset(pc_cache_misses, 0, sizeof(pc_cache_misses));
+    memset(function_calls, 0, sizeof(function_calls));
+    memset(function_inclusive, 0, sizeof(function_inclusive));
+    memset(function_exclusive, 0, sizeof(function_exclusive));
+    memset(function_inclusive_misses, 0, sizeof(function_inclusive_misses));
+    memset(function_exclusive_misses, 0, sizeof(function_exclusive_misses));
+    profiled_instructions = profiled_misses = 0;
+    enter_open_frames();
+}
+
+// Function to count one executed instruction
+void profile_retire(retired_instr* retired){
+    unsigned index = retired->pc / 4;
+    unsigned opcode = retired->instruction & 0x7f;
+    pc_executions[index]++;
+    pc_taken[index] += retired->next_pc != retired->pc + 4;
+    pc_memory_ops[index] += opcode == 0x3 || opcode == 0x23;
+    pc_cache_hits[index] += retired->cache_hits;
+    pc_cache_misses[index] += retired->cache_misses;
+
+    // Calls count towards the callee and returns towards the caller, matching the inclusive counts
+    int function = stack_top >= 0 ? call_stack[stack_top].label_id + 1 : 0;
+    function_exclusive[function]++;
+    function_exclusive_misses[function] += retired->cache_misses;
+    profiled_instructions++;
+    profiled_misses += retired->cache_misses;
+}
+
+// Function to record a call, called by push_stack()
+void profile_enter(call_frame* frame){
+    int function = frame->label_id + 1;
+    frame->entry_instructions = profiled_instructions;
+    frame->entry_misses = profiled_misses;
+    function_calls[function]++;
+    function_active[function]++;
+}
+
+// Function to record a return, recursive calls only count once towards the inclusive totals
+void profile_leave(call_frame* frame){
+    int function = frame->label_id + 1;
+    if(function_active[function] == 0) return;
+    if(--function_active[function] == 0){
+        function_inclusive[function] += profiled_instructions - frame->entry_instructions;
+        function_inclusive_misses[function] += profiled_misses - frame->entry_misses;
+    }
+}
+
+// Function to name an encoded instruction for the opcode mix
+const char* instruction_mnemonic(unsigned instruction){
+    static const char* r_names[8] = {"add", "sll", "slt", "sltu", "xor", "srl", "or", "and"};
+    static const char* i_names[8] = {"addi", "slli", "slti", "sltiu", "xori", "srli", "ori", "andi"};
+    static const char* load_names[8] = {"lb", "lh", "lw", "ld", "lbu", "lhu", "lwu", "unknown"};
+    static const char* store_names[8] = {"sb", "sh", "sw", "sd", "unknown", "unknown", "unknown", "unknown"};
+    static const char* branch_names[8] = {"beq", "bne", "unknown", "unknown", "blt", "bge", "bltu", "bgeu"};
+    static const char* m_names[8] = {"mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu"};
+    static const char* mw_names[8] = {"mulw", "unknown", "unknown", "unknown", "divw", "divuw", "remw", "remuw"};
+    static const char* w_names[8] = {"addw", "sllw", "unknown", "unknown", "unknown", "srlw", "unknown", "unknown"};
+    static const char* iw_names[8] = {"addiw", "slliw", "unknown", "unknown", "unknown", "srliw", "unknown", "unknown"};
+    static const char* csr_names[8] = {"unknown", "csrrw", "csrrs", "csrrc", "unknown", "csrrwi", "csrrsi", "csrrci"};
+    unsigned opcode = instruction & 0x7f;
+    unsigned funct3 = (instruction >> 12) & 0x7;
+    unsigned funct7 = (instruction >> 25) & 0x7f;
+
+    switch(opcode){
+        case 0x33:
+            if(funct7 == 0x20 && funct3 == 0) return "sub";
+            if(funct7 == 0x20 && funct3 == 5) return "sra";
+            if(funct7 == 0x01) return m_names[funct3];
+            return r_names[funct3];
+        case 0x3b:
+            if(funct7 == 0x01) return mw_names[funct3];
+            if(funct7 == 0x20) return funct3 == 0 ? "subw" : funct3 == 5 ? "sraw" : "unknown";
+            return w_names[funct3];
+        case 0x1b:
+            if(funct3 == 5 && funct7 == 0x20) return "sraiw";
+            return iw_names[funct3];
+        case 0x13:
+            if(funct3 == 5 && (funct7 & 0x7e) == 0x20) return "srai";
+            return i_names[funct3];
+        case 0x3: return load_names[funct3];
+        case 0x23: return store_names[funct3];
+        case 0x63: return branch_names[funct3];
+        case 0x6f: return "jal";
+        case 0x67: return "jalr";
+        case 0x37: return "lui";
+        case 0x17: return "auipc";
+        case 0x73: return csr_names[funct3];
+        default: return "unknown";
+    }
+}
+
+// Function to order instruction indices by execution count, most executed first
+int compare_executions(const void* a, const void* b){
+    unsigned long long x = pc_executions[*(const int*)a], y = pc_executions[*(const int*)b];
+    return (x < y) - (x > y);
+}
+
+// Function to print inclusive and exclusive counts per function, frames still open count up to now
+void print_call_graph(){
+    unsigned long long inclusive[MAX_LABELS + 1], inclusive_misses[MAX_LABELS + 1];
+    int open[MAX_LABELS + 1] = {0};
+    memcpy(inclusive, function_inclusive, sizeof(inclusive));
+    memcpy(inclusive_misses, function_inclusive_misses, sizeof(inclusive_misses));
+    for(int i = 0; i <= stack_top; i++){
+        int function = call_stack[i].label_id + 1;
+        if(open[function]++ || function_active[function] == 0) continue;
+        inclusive[function] += profiled_instructions - call_stack[i].entry_instructions;
+        inclusive_misses[function] += profiled_misses - call_stack[i].entry_misses;
+    }
+
+    printf("Call graph:\n");
+    printf("  %-24s %10s %14s %14s %12s %12s\n", "Function", "Calls", "Inclusive", "Exclusive", "Incl misses", "Excl misses");
+    for(int f = 0; f <= label_count && f <= MAX_LABELS; f++){
+        if(function_calls[f] == 0 && function_exclusive[f] == 0) continue;
+        printf("  %-24s %10llu %14llu %14llu %12llu %12llu\n", frame_name(f - 1), function_calls[f],
+               inclusive[f], function_exclusive[f], inclusive_misses[f], function_exclusive_misses[f]);
+    }
+}
+
+// Function to print the hottest instructions with their source lines and the opcode mix
+void print_profile(int top){
+    int* order = malloc(instr_count * sizeof(int));
+    int executed = 0;
+    unsigned long long total = 0;
+    for(int i = 0; i < instr_count; i++){
+        if(pc_executions[i] == 0) continue;
+        order[executed++] = i;
+        total += pc_executions[i];
+    }
+    if(total == 0){
+        printf("No profile recorded\n");
+        free(order);
+        return;
+    }
+    qsort(order, executed, sizeof(int), compare_executions);
+
+    printf("Profile: %llu instructions executed\n", total);
+    printf("%-10s %-6s %-30s %12s %7s %10s %10s %10s %10s\n", "PC", "Line", "Instruction", "Executions", "%", "Taken", "Mem ops", "Hits", "Misses");
+    for(int k = 0; k < executed && k < top; k++){
+        int i = order[k];
+        printf("0x%08x %-6d %-30s %12llu %6.2f%% %10llu %10llu %10llu %10llu\n", i * 4, instruction_lines[i], instructions[i],
+               pc_executions[i], 100.0 * pc_executions[i] / total, pc_taken[i], pc_memory_ops[i], pc_cache_hits[i], pc_cache_misses[i]);
+    }
+    if(!cache_enabled) printf("(cache columns are only counted while the cache simulator is enabled)\n");
+
+    // Opcode mix, the per-PC counts are summed by mnemonic
+    const char* names[64];
+    unsigned long long counts[64];
+    int kinds = 0;
+    for(int k = 0; k < executed; k++){
+        const char* name = instruction_mnemonic(text_section[order[k]]);
+        int j = 0;
+        while(j < kinds && strcmp(names[j], name) != 0) j++;
+        if(j == kinds){
+            if(kinds == 64) continue;
+            names[kinds] = name;
+            counts[kinds++] = 0;
+        }
+        counts[j] += pc_executions[order[k]];
+    }
+    for(int j = 1; j < kinds; j++){
+        for(int m = j; m > 0 && counts[m] > counts[m - 1]; m--){
+            unsigned long long count = counts[m];
+            const char* name = names[m];
+            counts[m] = counts[m - 1];
+            names[m] = names[m - 1];
+            counts[m - 1] = count;
+            names[m - 1] = name;
+        }
+    }
+    printf("Opcode mix:\n");
+    for(int j = 0; j < kinds; j++) printf("  %-8s %12llu %6.2f%%\n", names[j], counts[j], 100.0 * counts[j] / total);
+    free(order);
+    print_call_graph();
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include <stdio.h>
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "simulator.h"
+
+#define PROFILE_TOP 20      // Instructions listed by default in the report
+
+extern int profiling_enabled;
+
+void enable_profiling();
+void disable_profiling();
+void profile_reset();
+void profile_retire(retired_instr* retired);
+void profile_enter(call_frame* frame);
+void enter_open_frames();
+void leave_open_frames();
+void profile_leave(call_frame* frame);
+void print_profile(int top);
+const char* instruction_mnemonic(unsigned instruction);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "pipeline.h"
+#include "ooo.h"
+#include "branch_predictor.h"
+#include "profiler.h"
+#include "roi.h"
+
+/*
+Outside a region of interest the timing models, the branch predictor and the profiler are switched off
+and the cache model is either switched off too (its dirty lines written back first) or, when warming,
+kept running so the region starts with warm tags
+The enabled flags are saved when switching off and restored when a region begins
+*/
+int roi_enabled = 0;
+int roi_warm = 0;               // 1 if the cache keeps running outside the regions
+int in_roi = 0;
+int models_parked = 0;          // 1 while the saved flags below are in effect
+int saved_cache, saved_pipeline, saved_ooo, saved_branch, saved_profiling;
+roi_stats roi_totals;
+roi_stats roi_start;            // Counters when the open region began
+
+// Function to switch the models off for execution outside a region
+void park_models(){
+    if(models_parked) return;
+    saved_cache = cache_enabled;
+    saved_pipeline = pipeline_enabled;
+    saved_ooo = ooo_enabled;
+    saved_branch = branch_predictor_enabled;
+    saved_profiling = profiling_enabled;
+    if(cache_enabled && !roi_warm){
+        flush_cache();
+        cache_enabled = 0;
+    }
+    if(profiling_enabled) leave_open_frames();
+    pipeline_enabled = ooo_enabled = branch_predictor_enabled = profiling_enabled = 0;
+    models_parked = 1;
+}
+
+// Function to switch the saved models back on
+void unpark_models(){
+    if(!models_parked) return;
+    if(saved_cache && !cache_enabled){
+        sync_cache_from_memory();
+        cache_enabled = 1;
+    }
+    pipeline_enabled = saved_pipeline;
+    ooo_enabled = saved_ooo;
+    branch_predictor_enabled = saved_branch;
+    if(saved_profiling){
+        profiling_enabled = 1;
+        enter_open_frames();    // Frames opened while parked start their inclusive counts now
+    }
+    models_parked = 0;
+}
+
+// Function to start scoping statistics to the regions between roi_begin and roi_end
+void enable_roi(int warm){
+    if(roi_enabled) unpark_models();
+    roi_enabled = 1;
+    roi_warm = warm;
+    in_roi = 0;
+    memset(&roi_totals, 0, sizeof(roi_totals));
+    park_models();
+    printf("Region of interest scoping enabled%s\n", warm ? ", the cache keeps warming outside regions" : "");
+}
+
+// Function to stop scoping, the models stay on from here
+void disable_roi(){
+    roi_finish();
+    roi_enabled = 0;
+    printf("Region of interest scoping disabled\n");
+}
+
+// Function to clear the region statistics when a new program is loaded
+void roi_reset(){
+    memset(&roi_totals, 0, sizeof(roi_totals));
+    in_roi = 0;
+    if(roi_enabled) park_models();
+}
+
+// Function to add the open region to the totals
+void close_region(){
+    roi_totals.instructions += instret - roi_start.instructions;
+    roi_totals.accesses += cache_accesses - roi_start.accesses;
+    roi_totals.hits += cache_hits - roi_start.hits;
+    roi_totals.misses += cache_misses - roi_start.misses;
+    in_roi = 0;
+}
+
+// Function to act on the marker instructions, roi_begin is addi x0 x0 1 and roi_end is addi x0 x0 2
+void roi_marker(unsigned instruction){
+    if(instruction == ROI_BEGIN_WORD && !in_roi){
+        unpark_models();
+        roi_start.instructions = instret;
+        roi_start.accesses = cache_accesses;
+        roi_start.hits = cache_hits;
+        roi_start.misses = cache_misses;
+        roi_totals.regions++;
+        in_roi = 1;
+    }
+    else if(instruction == ROI_END_WORD && in_roi){
+        close_region();
+        park_models();
+    }
+}
+
+// Function to close an open region and switch the models back on so their reports can be printed
+void roi_finish(){
+    if(!roi_enabled) return;
+    if(in_roi) close_region();
+    unpark_models();
+}
+
+// Function to print the region statistics next to the whole-run values
+void print_roi_stats(){
+    if(!roi_enabled){
+        printf("Region of interest scoping is disabled\n");
+        return;
+    }
+    printf("Regions of interest: %lld\n", roi_totals.regions);
+    printf("%-16s %14s %14s\n", "", "ROI", "Whole run");
+    printf("%-16s %14lld %14lld\n", "Instructions", roi_totals.instructions, instret);
+    if(cache == NULL) return;
+    if(roi_warm){
+        printf("%-16s %14lld %14lld\n", "Cache accesses", roi_totals.accesses, cache_accesses);
+        printf("%-16s %14lld %14lld\n", "Cache hits", roi_totals.hits, cache_hits);
+        printf("%-16s %14lld %14lld\n", "Cache misses", roi_totals.misses, cache_misses);
+    }
+    else{
+        printf("%-16s %14lld %14s\n", "Cache accesses", roi_totals.accesses, "-");
+        printf("%-16s %14lld %14s\n", "Cache hits", roi_totals.hits, "-");
+        printf("%-16s %14lld %14s\n", "Cache misses", roi_totals.misses, "-");
+        printf("(the cache model is off outside the regions, use roi enable warm to keep it running)\n");
+    }
+    if(roi_totals.accesses > 0) printf("ROI miss rate: %.4f\n", (double)roi_totals.misses / roi_totals.accesses);
+    printf("Timing, branch and profile reports cover the regions only\n");
+}
\ No newline at end of file
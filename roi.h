@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+#ifndef ROI_H
+#define ROI_H
+
+#include "simulator.h"
+
+typedef struct{
+    long long regions;          // Completed or open regions of interest
+    long long instructions;
+    long long accesses;
+    long long hits;
+    long long misses;
+} roi_stats;
+
+extern int roi_enabled;
+
+void enable_roi(int warm);
+void disable_roi();
+void roi_reset();
+void roi_marker(unsigned instruction);
+void roi_finish();
+void print_roi_stats();
+
+#endif
\ No newline at end of file
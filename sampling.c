@@ -0,0 +1,137 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<math.h>
+#include "simulator.h"
+#include "cache.h"
+#include "sampling.h"
+#include "pipeline.h"
+#include "ooo.h"
+
+// Two sided 95% Student t values for 1 to 30 degrees of freedom
+const double t_values[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+// Function to compute the half width of the 95% confidence interval of the pooled miss ratio
+double confidence_half_width(sample_stats* samples, int count, double ratio){
+    /*
+    The estimate is the ratio of total misses to total accesses, so the spread is taken with the
+    ratio estimator variance: the residuals misses - ratio * accesses of each sample, scaled by
+    the mean number of accesses per sample
+    */
+    if(count < 2) return NAN;   // A single sample says nothing about the spread
+    double residuals = 0, accesses = 0;
+    for(int i = 0; i < count; i++){
+        double residual = samples[i].misses - ratio * samples[i].accesses;
+        residuals += residual * residual;
+        accesses += samples[i].accesses;
+    }
+    double mean_accesses = accesses / count;
+    double variance = residuals / (count - 1) / (count * mean_accesses * mean_accesses);
+    double t = (count - 1 <= 30) ? t_values[count - 2] : 1.96;
+    return t * sqrt(variance);
+}
+
+// Runs the rest of the program in periodic fast-forward, warm-up and detailed windows
+void sample_run(long long fast_forward, long long warmup, long long detail){
+    /*
+    Fast-forward runs with the cache model switched off and nothing printed
+    Warm-up runs through the cache so tags and replacement state catch up, but its statistics are dropped
+    Detail runs through the cache and its statistics make up one sample
+    The memory image is kept coherent by writing dirty lines back before switching the cache off
+    and refreshing the line contents before switching it back on
+    */
+    if(cache == NULL){
+        printf("Error: Enable the cache with cache_sim enable <file_name> before sampling\n");
+        return;
+    }
+    if(!cache_enabled){     // Switched off by cache_sim disable or outside a region of interest, its lines may be stale
+        printf("Error: The cache model is switched off, enable it with cache_sim enable <file_name> before sampling\n");
+        return;
+    }
+    if(pc >= (unsigned)instr_count * 4){
+        printf("Nothing to run.\n");
+        return;
+    }
+
+    int capacity = 64, count = 0;
+    sample_stats* samples = malloc(capacity * sizeof(sample_stats));
+    long long total_instructions = 0;
+    printf("Running sampled simulation (fast-forward %lld, warm-up %lld, detail %lld)...\n", fast_forward, warmup, detail);
+
+    int cached = cache_enabled, timed = pipeline_enabled, timed_ooo = ooo_enabled;
+    while(pc < (unsigned)instr_count * 4){
+        flush_cache();
+        cache_enabled = 0;
+        pipeline_enabled = 0;   // Fast-forward is purely functional
+        ooo_enabled = 0;
+        total_instructions += run_quiet(fast_forward);
+        sync_cache_from_memory();
+        cache_enabled = cached;
+        pipeline_enabled = timed;
+        ooo_enabled = timed_ooo;
+
+        long long saved_accesses = cache_accesses, saved_hits = cache_hits, saved_misses = cache_misses;
+        total_instructions += run_quiet(warmup);
+        cache_accesses = saved_accesses;
+        cache_hits = saved_hits;
+        cache_misses = saved_misses;
+
+        sample_stats sample = {0, cache_accesses, cache_hits, cache_misses};
+        sample.instructions = run_quiet(detail);
+        total_instructions += sample.instructions;
+        sample.accesses = cache_accesses - sample.accesses;
+        sample.hits = cache_hits - sample.hits;
+        sample.misses = cache_misses - sample.misses;
+        if(sample.instructions == 0) continue;
+
+        if(count == capacity){
+            capacity *= 2;
+            samples = realloc(samples, capacity * sizeof(sample_stats));
+        }
+        samples[count++] = sample;
+    }
+    if(!cache_enabled){     // The program ended while fast-forwarding
+        sync_cache_from_memory();
+        cache_enabled = cached;
+        pipeline_enabled = timed;
+        ooo_enabled = timed_ooo;
+    }
+    pop_stack();
+
+    // Combining the samples, the ratio estimate weighs each sample by its number of accesses
+    sample_stats measured = {0, 0, 0, 0};
+    for(int i = 0; i < count; i++){
+        measured.instructions += samples[i].instructions;
+        measured.accesses += samples[i].accesses;
+        measured.hits += samples[i].hits;
+        measured.misses += samples[i].misses;
+    }
+    printf("Sampled simulation complete: %d samples, %lld of %lld instructions in detail (%.2f%%)\n",
+           count, measured.instructions, total_instructions, total_instructions ? 100.0 * measured.instructions / total_instructions : 0.0);
+    if(measured.accesses == 0){
+        printf("No cache accesses in the detailed windows.\n");
+        free(samples);
+        return;
+    }
+
+    double miss_rate = (double)measured.misses / measured.accesses;
+    double half_width = confidence_half_width(samples, count, miss_rate);
+    double accesses_per_instruction = (double)measured.accesses / measured.instructions;
+    long long estimated_accesses = llround(accesses_per_instruction * total_instructions);
+    long long estimated_misses = llround(miss_rate * estimated_accesses);
+
+    if(isnan(half_width)){
+        printf("Miss rate: %.4f (too few samples for a confidence interval)\n", miss_rate);
+        printf("Hit rate: %.4f\n", 1 - miss_rate);
+    }
+    else{
+        printf("Miss rate: %.4f +/- %.4f (95%% CI)\n", miss_rate, half_width);
+        printf("Hit rate: %.4f +/- %.4f (95%% CI)\n", 1 - miss_rate, half_width);
+    }
+    printf("Estimated whole-program accesses: %lld, hits: %lld, misses: %lld\n",
+           estimated_accesses, estimated_accesses - estimated_misses, estimated_misses);
+    free(samples);
+}
\ No newline at end of file
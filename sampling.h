@@ -0,0 +1,13 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+typedef struct{
+    long long instructions;     // Instructions simulated in detail
+    long long accesses;
+    long long hits;
+    long long misses;
+} sample_stats;
+
+void sample_run(long long fast_forward, long long warmup, long long detail);
+
+#endif
\ No newline at end of file
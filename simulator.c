@@ -1,5 +1,25 @@
 #include "assembler.h"  // Necessary imports
 #include "cache.h"
+#include "simulator.h"
+#include "asm_cache.h"
+#include "elf_loader.h"
+#include "checkpoint.h"
+#include "sampling.h"
+#include "pipeline.h"
+#include "ooo.h"
+#include "branch_predictor.h"
+#include "profiler.h"
+#include "roi.h"
+#include "bench.h"
+#include "host_stats.h"
+#include "timing_thread.h"
+#include "prefetcher.h"
+#include "cache_buffers.h"
+#include "miss_classifier.h"
+#include "intervals.h"
+#include "heatmap.h"
+#include "dram.h"
+#include "vm.h"
 #include<stdio.h>
 #include<string.h>
 #include<stdlib.h>
@@ -14,330 +34,78 @@ unsigned stack_pointer = STACK_START;
 
 int instr_count = 0;    // Used to keep track of number of instructions in the input file
 
-char instructions[MAX_LINES][MAX_LINE_LEN];  // 2D array to store instructions from the input file
-int instruction_lines[MAX_LINES];   // Keeping track of line numbers of instructions
+char instructions[MAX_INSTRS][MAX_LINE_LEN];  // 2D array to store instructions from the input file
+int instruction_lines[MAX_INSTRS];   // Keeping track of line numbers of instructions
 
-typedef struct call_frame{
-    char* label;
-    int line_num;
-} call_frame;
-
-call_frame call_stack[MAX_LINES];  // Call stack
+call_frame* call_stack = NULL;  // Shadow call stack of label IDs, grows by doubling
+int stack_capacity = 0;
 int stack_top = -1;  // Points to the top of the stack
+int label_ids[MAX_INSTRS];  // Label ID of the first label at every text address, -1 for none
 
-int break_points[MAX_LINES] = {0};
+int break_points[MAX_INSTRS] = {0};
 
 char filename[256];
 
 FILE* cache_stat_ptr = NULL;
 
-int cache_accesses = 0;
-int cache_hits = 0;
-int cache_misses = 0;
-int cache_clock = 0;
-
-CacheLine* select_eviction_line(CacheSet* set){
-    CacheLine* eviction_line = NULL;
-    int oldest_load_time = INT_MAX;
-    int oldest_access_time = INT_MAX;
-    int min_frequency = INT_MAX;
-
-    // Choosing a random victim if the policy is random
-    if(strcmp(replacement_policy, "RANDOM") == 0){
-        int random_index = rand() % cache->lines_per_set;
-        return &set->lines[random_index];
-    }
-
-    for(int i = 0; i < cache->lines_per_set; i++){
-        CacheLine* line = &set->lines[i];
-        if(!line->valid) return line;   // Pick an empty line if we can
+unsigned last_mem_address = 0;  // Effective address of the most recent load or store
+long long instret = 0;  // Retired instructions, read through the instret CSR
 
-        if(strcmp(replacement_policy, "LRU") == 0){
-            if(line->last_access_time < oldest_access_time){
-                oldest_access_time = line->last_access_time;
-                eviction_line = line;
-            }
-        }
-        else if(strcmp(replacement_policy, "FIFO") == 0){
-            if(line->load_time < oldest_load_time){
-                oldest_load_time = line->load_time;
-                eviction_line = line;
-            }
-        }
-        else if(strcmp(replacement_policy, "LFU") == 0){
-            if(line->frequency < min_frequency ||
-               (line->frequency == min_frequency && line->last_access_time < oldest_access_time)){
-                min_frequency = line->frequency;
-                oldest_access_time = line->last_access_time;
-                eviction_line = line;
-            }
-        }
+// Function to read a load's data straight from memory, extended the same way as cache_read()
+long long read_data_from_memory(unsigned address, int funct3){
+    int bytes_to_read = 1 << (funct3 & 0x3);
+    unsigned long long value = 0;
+    for(int i = 0; i < bytes_to_read; i++){
+        value |= (unsigned long long)(data_section[address + i - DATA_START] & 0xff) << (8 * i);
     }
-    return eviction_line;
-}
-
-// Used to load one block of memory into chosen cache line
-void load_block_from_memory(CacheLine* line, unsigned address){
-    unsigned block_start = address - (address % block_size);
-    memcpy(line->block, &data_section[block_start - DATA_START], block_size);
-}
-
-// Function to update cache line access times
-void update_access_time(CacheLine* line){
-    line->last_access_time = cache_clock;
-    line->frequency++;
-    cache_clock++;
+    int shift = 64 - 8 * bytes_to_read;
+    if(funct3 & 0x4) return (long long)value;
+    return (long long)(value << shift) >> shift;
 }
 
-// Function to directly write data into memory
-void write_data_to_memory(unsigned address, long long data, int funct3){
-    if(funct3 == 0x0){
-        data_section[address - DATA_START] = data & 0xff;
-    }
-    else if (funct3 == 0x1){
-        data_section[address - DATA_START] = data & 0xff;
-        data_section[address + 1 - DATA_START] = (data >> 8) & 0xff;
-    }
-    else if (funct3 == 0x2){
-        data_section[address - DATA_START] = data & 0xff;
-        data_section[address + 1 - DATA_START] = (data >> 8) & 0xff;
-        data_section[address + 2 - DATA_START] = (data >> 16) & 0xff;
-        data_section[address + 3 - DATA_START] = (data >> 24) & 0xff;
-    }
-    else if (funct3 == 0x3){
-        data_section[address - DATA_START] = data & 0xff;
-        data_section[address + 1 - DATA_START] = (data >> 8) & 0xff;
-        data_section[address + 2 - DATA_START] = (data >> 16) & 0xff;
-        data_section[address + 3 - DATA_START] = (data >> 24) & 0xff;
-        data_section[address + 4 - DATA_START] = (data >> 32) & 0xff;
-        data_section[address + 5 - DATA_START] = (data >> 40) & 0xff;
-        data_section[address + 6 - DATA_START] = (data >> 48) & 0xff;
-        data_section[address + 7 - DATA_START] = (data >> 56) & 0xff;
+// Function to build the address to label ID table once the labels of a program are known
+void index_labels(){
+    memset(label_ids, 0xff, sizeof(label_ids));
+    for(int i = label_count - 1; i >= 0; i--){  // Walking backwards so the first label at an address wins
+        unsigned address = labels[i].address;
+        if(address % 4 == 0 && address / 4 < MAX_INSTRS) label_ids[address / 4] = i;
     }
 }
-
-// Function to write into a chosen cache line
-void write_data_to_cache_line(unsigned address, long long data, int funct3){
-    cache_accesses++;
-    int bytes_to_write;
-    switch(funct3){
-        case 0x0: bytes_to_write = 1; break;
-        case 0x1: bytes_to_write = 2; break;
-        case 0x2: bytes_to_write = 4; break;
-        case 0x3: bytes_to_write = 8; break;
-        default: return;
-    }
-
-    int bytes_written = 0;
-    while(bytes_written < bytes_to_write){
-        unsigned current_address = address + bytes_written;
-        unsigned tag;
-        int set_index;
-        calculate_cache_address(current_address, &tag, &set_index);
-
-        CacheSet* set = &cache->sets[set_index];
-        CacheLine* target_line = NULL;
-
-        for(int i = 0; i < cache->lines_per_set; i++){
-            if(set->lines[i].valid && set->lines[i].tag == tag){
-                target_line = &set->lines[i];
-                break;
-            }
-        }
-
-        if(!target_line){
-            cache_misses++;
-            target_line = select_eviction_line(set);
-            if(target_line->dirty && strcmp(write_back_policy, "WB") == 0){
-                unsigned mem_address = (target_line->tag << (__builtin_ctz(block_size) + __builtin_ctz(cache->num_sets))) | (set_index << __builtin_ctz(block_size));
-                write_data_to_memory(mem_address, *(long long*)(target_line->block), funct3);
-            }
-            load_block_from_memory(target_line, current_address);
-            target_line->tag = tag;
-            target_line->valid = 1;
-            target_line->dirty = 0;
-        }
-        else{
-            cache_hits++;
-            update_access_time(target_line);
-        }
-        
-        int offset = current_address % block_size;
-        int bytes_in_line = block_size - offset;
-        int bytes_this_write = (bytes_written + bytes_in_line > bytes_to_write) ? (bytes_to_write - bytes_written) : bytes_in_line;
-
-        for(int i = 0; i < bytes_this_write; i++){
-            target_line->block[offset + i] = (data >> (8 * bytes_written)) & 0xff;
-        }
-
-        target_line->dirty = 1;
-        bytes_written += bytes_this_write;
-
-        if(strcmp(write_back_policy, "WT") == 0) write_data_to_memory(current_address, data, funct3);
-    }
+// Function to find the label at a text address, returns -1 if there is none
+int label_at_address(unsigned address){
+    if(address % 4 != 0 || address / 4 >= MAX_INSTRS) return -1;
+    return label_ids[address / 4];
 }
-
-// Function to handle misses while writing into cache
-void handle_write_miss(unsigned address, long long data, int funct3){
-    cache_misses++;
-    unsigned tag;
-    int set_index;
-    calculate_cache_address(address, &tag, &set_index);
-    CacheSet* set = &cache->sets[set_index];
-    CacheLine* line = select_eviction_line(set);
-
-    if(line->dirty && strcmp(write_back_policy, "WB") == 0){
-        unsigned evict_address = (line->tag << (__builtin_ctz(block_size) + __builtin_ctz(cache->num_sets))) | (set_index << __builtin_ctz(block_size));
-        write_data_to_memory(evict_address, *(int*)(line->block), funct3);
+// Function to find the first instruction at or after a source line, returns -1 if there is none
+int instruction_at_line(int line_num){
+    for(int i = 0; i < instr_count; i++){
+        if(instruction_lines[i] >= line_num) return i;
     }
-
-    line->tag = tag;
-    line->valid = 1;
-    line->dirty = 0;
-
-    memcpy(line->block, &data_section[address - (address % block_size) - DATA_START], block_size);
-    write_data_to_cache_line(address, data, funct3);
-
-    if(strcmp(write_back_policy, "WT") == 0) write_data_to_memory(address, data, funct3);
-    else if(strcmp(write_back_policy, "WB") == 0) line->dirty = 1;
+    return -1;
 }
-
-// Method to write into cache
-void cache_write(unsigned address, long long data, int funct3){
-    cache_accesses++;
-    unsigned tag;
-    int set_index;
-    calculate_cache_address(address, &tag, &set_index);
-
-    CacheSet* set = &(cache->sets[set_index]);
-    for(int i = 0; i < cache->lines_per_set; i++){
-        CacheLine* line = &(set->lines[i]);
-        if(line->valid && line->tag == tag){
-            cache_hits++;
-            write_data_to_cache_line(address, data, funct3);
-            if(strcmp(write_back_policy, "WB") == 0) line->dirty = 1;
-            else if(strcmp(write_back_policy, "WT") == 0) write_data_to_memory(address, data, funct3);
-            return;
-        }
-    }
-    handle_write_miss(address, data, funct3);
+// Function to name a call stack entry
+const char* frame_name(int label_id){
+    return label_id == MAIN_FRAME ? "main" : labels[label_id].name;
 }
-
-int read_data_from_cache_line(CacheLine* line, unsigned address, int funct3){
-    int offset = address % block_size;
-    int data = 0;
-
-    switch(funct3){
-        case 0x0:
-            data = line->block[offset];
-            break;
-        case 0x1:
-            data = line->block[offset] | (line->block[offset + 1] << 8);
-            break;
-        case 0x2:
-            data = line->block[offset] | (line->block[offset + 1] << 8) |
-                   (line->block[offset + 2] << 16) | (line->block[offset + 3] << 24);
-            break;
-        case 0x3:
-            data = *(long long int*)(line->block + offset);
-            break;
-    }
-    return data;
-}
-
-int cache_read(unsigned address, int funct3, long long* read_data){
-    cache_accesses++;
-    unsigned tag;
-    int set_index;
-    int offset = address % block_size;
-
-    int bytes_to_read;
-    switch(funct3){
-        case 0x0:
-            bytes_to_read = 1;
-            break;
-        case 0x1:
-            bytes_to_read = 2;
-            break;
-        case 0x2:
-            bytes_to_read = 4;
-            break;
-        case 0x3:
-            bytes_to_read = 8;
-            break;
-        default:
-            return -1;
-    }
-
-    int bytes_read = 0;
-    while(bytes_read < bytes_to_read){
-        unsigned current_address = address + bytes_read;
-        calculate_cache_address(current_address, &tag, &set_index);
-
-        CacheSet* set = &cache->sets[set_index];
-        CacheLine* target_line = NULL;
-
-        for(int i = 0; i < cache->lines_per_set; i++){
-            if(set->lines[i].valid && set->lines[i].tag == tag){
-                target_line = &set->lines[i];
-                break;
-            }
-        }
-
-        if(target_line == NULL){
-            cache_misses++;
-            target_line = select_eviction_line(set);
-            if(target_line->dirty && strcmp(write_back_policy, "WB") == 0){
-                unsigned mem_address = (target_line->tag << (__builtin_ctz(block_size) + __builtin_ctz(cache->num_sets))) |
-                                       (set_index << __builtin_ctz(block_size));
-                write_data_to_memory(mem_address, *(int*)(target_line->block), funct3);
-            }
-
-            load_block_from_memory(target_line, current_address);
-            target_line->tag = tag;
-            target_line->valid = 1;
-            target_line->dirty = 0;
-        }
-        else{
-            cache_hits++;
-            update_access_time(target_line);
-        }
-
-        int bytes_in_line = block_size - offset;
-        int bytes_this_read = (bytes_read + bytes_in_line > bytes_to_read) ? (bytes_to_read - bytes_read) : bytes_in_line;
-
-        for(int i = 0; i < bytes_this_read; i++){
-            *read_data |= ((long long)target_line->block[offset + i] << (8 * bytes_read));
-            bytes_read++;
-        }
-    }
-    return 0;
-}
-
 // Function to push labels onto stack(for jal)
-void push_stack(const char* label, int start){
-    if(!start){
-        if(stack_top < MAX_LINES){
-            stack_top += 1;
-            call_stack[stack_top].label = strdup(label);
-            call_stack[stack_top].line_num = instruction_lines[pc / 4];
-        }
-        else printf("Error: Stack overflow.\n");
+void push_stack(int label_id){
+    if(stack_top + 1 >= MAX_CALL_DEPTH){
+        printf("Error: Stack overflow.\n");
+        return;
     }
-    else{
-        if(stack_top < MAX_LINES){
-            stack_top += 1;
-            call_stack[stack_top].label = "main";
-            call_stack[stack_top].line_num = pc / 4;
-        }
-        else printf("Error: Stack overflow.\n");
+    if(stack_top + 1 == stack_capacity){
+        stack_capacity = stack_capacity ? stack_capacity * 2 : MAX_LINES;
+        call_stack = realloc(call_stack, stack_capacity * sizeof(call_frame));
     }
+    stack_top += 1;
+    call_stack[stack_top].label_id = label_id;
+    call_stack[stack_top].line_num = pc / 4 < MAX_INSTRS ? instruction_lines[pc / 4] : 0;
+    if(profiling_enabled) profile_enter(&call_stack[stack_top]);
 }
 // Function to pop labels from stack(for jalr)
 void pop_stack(){
     if(stack_top > -1){  // Ensure 'main' remains at the bottom
-        free(call_stack[stack_top].label);  // Free the top entry
-        call_stack[stack_top].line_num = 0;
+        if(profiling_enabled) profile_leave(&call_stack[stack_top]);
         stack_top -= 1;
     }
 }
@@ -346,18 +114,21 @@ void show_stack(){
     printf("Call Stack:\n");
     if(stack_top == -1) printf("Empty Call Stack: Execution complete");
     for(int i = 0; i <= stack_top; i++){
-        printf("%s:%d\n", call_stack[i].label, call_stack[i].line_num);
+        printf("%s:%d\n", frame_name(call_stack[i].label_id), call_stack[i].line_num);
     }
 }
 // Function to reset the values of all memory locations, registers, etc
 void reset(){
-    memset(text_section, 0, DATA_START / 4);
-    memset(data_section, 0, STACK_START - DATA_START);
-    memset(registers, 0, NUM_REGS);
-    memset(break_points, 0, 64);
-    memset(instruction_lines, 0, MAX_LINES);
+    memset(text_section, 0, sizeof(text_section));
+    memset(data_section, 0, sizeof(data_section));
+    memset(registers, 0, sizeof(registers));
+    memset(break_points, 0, sizeof(break_points));
+    memset(instruction_lines, 0, sizeof(instruction_lines));
 
     instr_count = 0;
+    label_count = 0;
+    data_label_count = 0;
+    data_end = DATA_START;
     pc = TEXT_START;
     stack_pointer = STACK_START;
 
@@ -365,14 +136,25 @@ void reset(){
     cache_hits = 0;
     cache_misses = 0;
     cache_clock = 0;
-
-    for(int i=0;i<MAX_LINES;i++){
-        memset(instructions[i], 0, MAX_LINE_LEN);
-    }
-    pop_stack();
+    instret = 0;
+    pipeline_reset();
+    ooo_reset();
+    branch_predictor_reset();
+    prefetcher_reset();
+    cache_buffers_reset();
+    miss_classifier_reset();
+    intervals_reset();
+    heatmap_reset();
+    dram_reset();
+    vm_reset();
+    profile_reset();
+    roi_reset();
+
+    memset(instructions, 0, sizeof(instructions));
+    while(stack_top > -1) pop_stack();
 }
 // Loads a file into instruction memory, performs necessary implementations
-void load(char *filename){
+void load_program(char *filename){
     reset();    // Resetting registers, instruction memory, etc
     // Opening file pointers
     FILE* fptr = fopen(filename, "r");
@@ -380,6 +162,23 @@ void load(char *filename){
         printf("Error: Cannot open file %s\n", filename);
         return;
     }
+    // Compiled executables bypass the assembler entirely
+    if(is_elf_file(fptr)){
+        fclose(fptr);
+        if(!load_elf(filename)) reset();    // Segments mapped before the error must not be runnable
+        return;
+    }
+
+    // Reusing the image of an identical earlier load if one is cached
+    unsigned long long source_hash = hash_source(fptr);
+    if(asm_cache_load(source_hash)){
+        pc = TEXT_START;
+        index_labels();
+        push_stack(MAIN_FRAME);
+        fclose(fptr);
+        printf("Loaded %d instructions into text section from %s (cached).\n", instr_count, filename);
+        return;
+    }
   
     FILE* optr = fopen("temp.hex", "w+");   // Creating a .hex file to store generated machine code, for user's benefit
     if(!optr){
@@ -399,6 +198,7 @@ void load(char *filename){
     unsigned line_number = 0;
 
     // Scanning for the presence of sections
+    unsigned long long phase_start = host_ticks();
     rewind(fptr);
     while(fgets(line, sizeof(line), fptr)){
         if(line[0] == '\n' || line[0] == ';' || line[0] == '#') continue;   // Accounting for empty lines and comments
@@ -415,6 +215,7 @@ void load(char *filename){
         
     }
     rewind(fptr);  // Rewinding the file pointer for actual processing
+    host_timer_add(HOST_LOAD_SCAN, phase_start);
     // Checking for rule violations
     if(has_data_section && !has_text_section){
         printf("Error: .text section is missing, but .data section is present.\n");
@@ -422,6 +223,7 @@ void load(char *filename){
         fclose(optr);
         return;
     }
+    phase_start = host_ticks();
     while(fgets(line, sizeof(line), fptr)){
         line_number++;
 
@@ -441,6 +243,18 @@ void load(char *filename){
         }
         // Handling the .data section content
         if(in_data_section){
+            int token_length = strlen(token);
+            if(token[token_length - 1] == ':'){
+                // A label names the data that follows it, on the same line or on the next ones
+                if(data_label_count < MAX_LABELS){
+                    token[token_length - 1] = '\0';
+                    strncpy(data_labels[data_label_count].name, token, MAX_LABEL_LEN - 1);
+                    data_labels[data_label_count].name[MAX_LABEL_LEN - 1] = '\0';
+                    data_labels[data_label_count++].address = memory_address;
+                }
+                token = strtok(NULL, " \t\n");
+                if(token == NULL) continue;
+            }
             if(strcmp(token, ".dword") == 0){
                 while((token = strtok(NULL, " ,\t\n")) != NULL){
                     // Checking if the token starts with "0x" for hexadecimal, otherwise use decimal
@@ -515,11 +329,18 @@ void load(char *filename){
 
         // Handling assembly instructions in the .text section
         if(in_text_section || (!has_text_section && !has_data_section)){
+            int assembled = 0;
+            host_timer_add(HOST_LOAD_DATA, phase_start);
             rewind(fptr);
+            phase_start = host_ticks();
             if(parse_labels(fptr)){
+                host_timer_add(HOST_LOAD_LABELS, phase_start);
                 rewind(fptr);
-                process_instructions(fptr, optr);
-                push_stack("main", 1);
+                phase_start = host_ticks();
+                assembled = process_instructions(fptr, optr);
+                host_timer_add(HOST_LOAD_ENCODE, phase_start);
+                index_labels();
+                push_stack(MAIN_FRAME);
             }
             else{
                 printf("Please rectify error and load the file once more\n");
@@ -529,10 +350,16 @@ void load(char *filename){
             }
 
             // Store instructions in a 2D array
+            phase_start = host_ticks();
             rewind(fptr);
             char buffer[MAX_LINE_LEN];
             int total_lines = 0;
+            int in_data = 0;
+            data_end = memory_address;
+            line_number = 0;
             while(fgets(buffer, sizeof(buffer), fptr) != NULL){
+                line_number++;  // Source line of the instruction, for break points and the call stack
+                if(skip_data_line(buffer, &in_data)) continue;
                 if(buffer[0] == '\n' || buffer[0] == ';' || buffer[0] == '#' || buffer[0] == '.') continue;  // Skip comments and blank lines
 
                 // Handle labels and instructions
@@ -554,10 +381,12 @@ void load(char *filename){
                 strcpy(instructions[total_lines], command_part);  // Store the command part
                 instruction_lines[total_lines] = line_number;
                 total_lines++;
-                line_number++;
             }
 
+            host_timer_extend(HOST_LOAD_SCAN, phase_start);
+
             // Load instructions into text section
+            phase_start = host_ticks();
             unsigned addr = 0;
             unsigned instruction;
             rewind(fptr);
@@ -566,13 +395,106 @@ void load(char *filename){
                 text_section[addr++] = instruction;
                 instr_count++;
             }
+            host_timer_extend(HOST_LOAD_ENCODE, phase_start);
             pc = TEXT_START;
             fclose(fptr);
             fclose(optr);
+            if(assembled) asm_cache_store(source_hash, memory_address - DATA_START, total_lines);
             printf("Loaded %d instructions into text section from %s.\n", addr, filename);
+            return;
+        }
+    }
+}
+// Function to load a file, timing the whole load for the host statistics
+void load(char *filename){
+    unsigned long long start = host_ticks();
+    load_program(filename);
+    host_timer_add(HOST_LOAD, start);
+}
+// Function to describe which registers an instruction reads and writes, 0 stands for none
+instr_info decode_operands(unsigned instruction){
+    instr_info info = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned opcode = instruction & 0x7f;
+    unsigned rd = (instruction >> 7) & 0x1f;
+    unsigned rs1 = (instruction >> 15) & 0x1f;
+    unsigned rs2 = (instruction >> 20) & 0x1f;
+
+    if(opcode == 0x33 || opcode == 0x3b){     // R-type and OP-32
+        info.rd = rd; info.rs1 = rs1; info.rs2 = rs2;
+        if((instruction >> 25) == 0x01){        // RV64M, funct3 0 to 3 multiply and 4 to 7 divide
+            if(instruction & 0x4000) info.is_divide = 1;
+            else info.is_multiply = 1;
         }
     }
+    else if(opcode == 0x13 || opcode == 0x1b){ info.rd = rd; info.rs1 = rs1; }               // I-type part 1 and OP-IMM-32
+    else if(opcode == 0x3){ info.rd = rd; info.rs1 = rs1; info.is_load = 1; }
+    else if(opcode == 0x23){ info.rs1 = rs1; info.rs2 = rs2; info.is_store = 1; }
+    else if(opcode == 0x63){ info.rs1 = rs1; info.rs2 = rs2; info.is_control = 1; }
+    else if(opcode == 0x67){ info.rd = rd; info.rs1 = rs1; info.is_control = 1; }   // jalr
+    else if(opcode == 0x6f){ info.rd = rd; info.is_control = 1; }                    // jal
+    else if(opcode == 0x37 || opcode == 0x17) info.rd = rd;                          // lui and auipc
+    else if(opcode == 0x73){ info.rd = rd; if(!(instruction & 0x4000)) info.rs1 = rs1; }    // Zicsr, the i forms have no rs1
+    return info;
+}
+// Function to count cycles for the cycle and time CSRs, taken from the timing model if one is active
+long long modeled_cycles(){
+    if(ooo_enabled) return core_stats.cycles;
+    if(pipeline_enabled) return pipe_stats.cycles;
+    return instret;     // The functional simulator retires one instruction per cycle
+}
+// Function to read a counter CSR, returns 0 for CSRs the simulator does not implement
+int read_csr(unsigned csr, long long* value){
+    if(csr != CSR_INSTRET) timing_drain();  // The model counters have to include every earlier instruction
+    if(csr == CSR_CYCLE || csr == CSR_TIME) *value = modeled_cycles();
+    else if(csr == CSR_INSTRET) *value = instret;
+    else if(csr == CSR_HPMCOUNTER3) *value = cache_accesses;
+    else if(csr == CSR_HPMCOUNTER3 + 1) *value = cache_hits;
+    else if(csr == CSR_HPMCOUNTER3 + 2) *value = cache_misses;
+    else if(csr == CSR_HPMCOUNTER3 + 3) *value = bp_stats.branch_mispredicts + bp_stats.jump_mispredicts;
+    else if(csr > CSR_HPMCOUNTER3 + 3 && csr <= CSR_HPMCOUNTER31) *value = 0;   // Not wired to any event
+    else return 0;
+    return 1;
+}
+// Function to compute an RV64M multiply or divide selected by funct3
+long long multiply_divide(unsigned funct3, long long a, long long b){
+    unsigned long long ua = a, ub = b;
+    switch(funct3){
+        case 0x0: return (long long)(ua * ub);                                     // mul
+        case 0x1: return (long long)(((__int128)a * b) >> 64);                     // mulh
+        case 0x2: return (long long)(((__int128)a * (__int128)ub) >> 64);          // mulhsu
+        case 0x3: return (long long)(((unsigned __int128)ua * ub) >> 64);          // mulhu
+        case 0x4:                                                                   // div
+            if(b == 0) return -1;
+            if(a == LLONG_MIN && b == -1) return LLONG_MIN;    // Overflow gives the dividend
+            return a / b;
+        case 0x5: return b == 0 ? -1 : (long long)(ua / ub);                       // divu
+        case 0x6:                                                                   // rem
+            if(b == 0) return a;
+            if(a == LLONG_MIN && b == -1) return 0;
+            return a % b;
+        default: return b == 0 ? a : (long long)(ua % ub);                         // remu
+    }
+}
+
+// Function to compute an RV64M word multiply or divide, the 32-bit result is sign extended
+long long multiply_divide_word(unsigned funct3, long long a, long long b){
+    int wa = (int)a, wb = (int)b;
+    unsigned ua = wa, ub = wb;
+    switch(funct3){
+        case 0x0: return (int)(ua * ub);                                            // mulw
+        case 0x4:                                                                   // divw
+            if(wb == 0) return -1;
+            if(wa == INT_MIN && wb == -1) return INT_MIN;
+            return wa / wb;
+        case 0x5: return wb == 0 ? -1 : (int)(ua / ub);                            // divuw
+        case 0x6:                                                                   // remw
+            if(wb == 0) return wa;
+            if(wa == INT_MIN && wb == -1) return 0;
+            return wa % wb;
+        default: return wb == 0 ? wa : (int)(ua % ub);                             // remuw
+    }
 }
+
 // Function used to execute any given instruction
 void execute_instruction(unsigned instruction){
     unsigned opcode = instruction & 0x7f;
@@ -599,26 +521,53 @@ void execute_instruction(unsigned instruction){
                 registers[rd] = registers[rs1] & registers[rs2];
             }
             else if(funct3 == 0x1 && funct7 == 0x00){
-                registers[rd] = registers[rs1] << (registers[rs2] & 0x1F);
+                registers[rd] = (unsigned long long)registers[rs1] << (registers[rs2] & 0x3F);
             }
             else if(funct3 == 0x5 && funct7 == 0x00){
-                registers[rd] = registers[rs1] >> (registers[rs2] & 0x1F);
+                registers[rd] = (unsigned long long)registers[rs1] >> (registers[rs2] & 0x3F);
             }
             else if(funct3 == 0x5 && funct7 == 0x20){
-                registers[rd] = (int)registers[rs1] >> (registers[rs2] & 0x1F);
+                registers[rd] = registers[rs1] >> (registers[rs2] & 0x3F);    // Arithmetic shift of the signed value
+            }
+            else if(funct3 == 0x2 && funct7 == 0x00){
+                registers[rd] = registers[rs1] < registers[rs2] ? 1 : 0;
+            }
+            else if(funct3 == 0x3 && funct7 == 0x00){
+                registers[rd] = (unsigned long long)registers[rs1] < (unsigned long long)registers[rs2] ? 1 : 0;
+            }
+            else if(funct7 == 0x01){
+                registers[rd] = multiply_divide(funct3, registers[rs1], registers[rs2]);
             }
         }
         pc += 4;     
     }
+    else if(opcode == 0x3b){  // OP-32, word operations on the low 32 bits
+        unsigned int funct3 = (instruction >> 12) & 0x7;
+        unsigned int rs1 = (instruction >> 15) & 0x1f;
+        unsigned int rs2 = (instruction >> 20) & 0x1f;
+        unsigned int rd = (instruction >> 7) & 0x1f;
+        unsigned int funct7 = (instruction >> 25) & 0x7f;
+        unsigned a = registers[rs1], b = registers[rs2];
+        if(rd != 0){
+            if(funct3 == 0x0 && funct7 == 0x00) registers[rd] = (int)(a + b);                   // addw
+            else if(funct3 == 0x0 && funct7 == 0x20) registers[rd] = (int)(a - b);              // subw
+            else if(funct3 == 0x1 && funct7 == 0x00) registers[rd] = (int)(a << (b & 0x1f));    // sllw
+            else if(funct3 == 0x5 && funct7 == 0x00) registers[rd] = (int)(a >> (b & 0x1f));    // srlw
+            else if(funct3 == 0x5 && funct7 == 0x20) registers[rd] = (int)a >> (b & 0x1f);      // sraw
+            else if(funct7 == 0x01 && funct3 != 0x1 && funct3 != 0x2 && funct3 != 0x3){
+                registers[rd] = multiply_divide_word(funct3, registers[rs1], registers[rs2]);
+            }
+        }
+        pc += 4;
+    }
     else if(opcode == 0x13){  // I-type part 1
         unsigned int funct3 = (instruction >> 12) & 0x7;
         unsigned int rs1 = (instruction >> 15) & 0x1F;
         unsigned int rd = (instruction >> 7) & 0x1f;
-        int imm = (instruction >> 20);
+        long long imm = (int)instruction >> 20;     // Sign extended 12-bit immediate
+        unsigned shamt = (instruction >> 20) & 0x3f;
+        unsigned shift_type = (instruction >> 26) & 0x3f;
 
-        if(imm & 0x800){
-            imm |= 0xfffff000;
-        }
         if(rd != 0){
             if(funct3 == 0x0){
                 registers[rd] = registers[rs1] + imm;
@@ -632,78 +581,68 @@ void execute_instruction(unsigned instruction){
             else if(funct3 == 0x7){
                 registers[rd] = registers[rs1] & imm;
             }
-            else if(funct3 == 0x1 && (imm & 0xfe0) == 0){
-                registers[rd] = registers[rs1] << (imm & 0x1f);
+            else if(funct3 == 0x1 && shift_type == 0x00){
+                registers[rd] = (unsigned long long)registers[rs1] << shamt;
             }
-            else if(funct3 == 0x5 && (imm & 0xfe0) == 0){
-                registers[rd] = (unsigned int)registers[rs1] >> (imm & 0x1f);
+            else if(funct3 == 0x5 && shift_type == 0x00){
+                registers[rd] = (unsigned long long)registers[rs1] >> shamt;
             }
-            else if(funct3 == 0x5 && (imm & 0xfe0) == 0x400){
-                registers[rd] = (int)registers[rs1] >> (imm & 0x1f);
+            else if(funct3 == 0x5 && shift_type == 0x10){
+                registers[rd] = registers[rs1] >> shamt;
             }
             else if(funct3 == 0x2){
-                registers[rd] = (int)registers[rs1] < imm ? 1 : 0;
+                registers[rd] = registers[rs1] < imm ? 1 : 0;
             }
             else if(funct3 == 0x3){
-                registers[rd] = (unsigned int)registers[rs1] < (unsigned int)imm ? 1 : 0;
+                registers[rd] = (unsigned long long)registers[rs1] < (unsigned long long)imm ? 1 : 0;
             }
         }
         pc += 4;
     }
+    else if(opcode == 0x1b){  // OP-IMM-32, word operations with an immediate
+        unsigned int funct3 = (instruction >> 12) & 0x7;
+        unsigned int rs1 = (instruction >> 15) & 0x1f;
+        unsigned int rd = (instruction >> 7) & 0x1f;
+        int imm = (int)instruction >> 20;
+        unsigned shamt = (instruction >> 20) & 0x1f;
+        unsigned funct7 = instruction >> 25;
+        unsigned a = registers[rs1];
+        if(rd != 0){
+            if(funct3 == 0x0) registers[rd] = (int)(a + imm);                        // addiw
+            else if(funct3 == 0x1 && funct7 == 0x00) registers[rd] = (int)(a << shamt);     // slliw
+            else if(funct3 == 0x5 && funct7 == 0x00) registers[rd] = (int)(a >> shamt);     // srliw
+            else if(funct3 == 0x5 && funct7 == 0x20) registers[rd] = (int)a >> shamt;       // sraiw
+        }
+        pc += 4;
+    }
+    else if(opcode == 0x17){  // AUIPC
+        unsigned rd = (instruction >> 7) & 0x1f;
+        int imm = instruction & 0xfffff000;
+        if(rd != 0) registers[rd] = (long long)pc + imm;
+        pc += 4;
+    }
     else if(opcode == 0x3){ // I-type part 2
         unsigned int funct3 = (instruction >> 12) & 0x7;
         unsigned int rs1 = (instruction >> 15) & 0x1f;
         unsigned int rd = (instruction >> 7) & 0x1f;
         long long int imm = (instruction >> 20);
 
-        if(imm & 0x800) imm |= 0xfffff000;
+        if(imm & 0x800) imm |= ~0xfffLL;  // Sign extension to all 64 bits
         
         unsigned address = registers[rs1] + imm;
+        last_mem_address = address;
+        if(vm_enabled && !timing_offloaded) vm_translate(address, VM_LOAD);
         
         if(rd!=0){
-            int cache_result;
-            if(cache_enabled){
-                long long read_data;
-                cache_result = cache_read(address, funct3, &read_data);  // Call cache_read() if cache is enabled
+            if(cache_enabled && !timing_offloaded){
+                long long read_data = 0;
+                unsigned long long start = host_cache_timing ? host_ticks() : 0;
+                cache_access_pc = pc;
+                cache_read(address, funct3, &read_data);  // Call cache_read() if cache is enabled
+                if(host_cache_timing) host_timer_add(HOST_CACHE, start);
                 registers[rd] = read_data;
             }
-            else{
-                if(funct3 == 0x0){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START];
-                    registers[rd] = registers[rd] << (64 - 8);
-                    registers[rd] = registers[rd] >> (64 - 8);
-                }
-                else if(funct3 == 0x1){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START] + (data_section[imm + 1 + registers[rs1] - DATA_START] << 8);
-                    registers[rd] = registers[rd] << (64 - 16);
-                    registers[rd] = registers[rd] >> (64 - 16);
-                }
-                else if(funct3 == 0x2){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START] + (data_section[imm + 1 + registers[rs1] - DATA_START] << 8);
-                    registers[rd] += (data_section[imm + 2 + registers[rs1] - DATA_START] << 16) + (data_section[imm + 3 + registers[rs1] - DATA_START] << 24);
-                    registers[rd] = registers[rd] << (64 - 32);
-                    registers[rd] = registers[rd] >> (64 - 32);
-                }
-                else if(funct3 == 0x3){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START] + (data_section[imm + 1 + registers[rs1] - DATA_START] << 8);
-                    registers[rd] += (data_section[imm + 2 + registers[rs1] - DATA_START] << 16) + (data_section[imm + 3 + registers[rs1] - DATA_START] << 24);
-                    registers[rd] += (data_section[imm + 4 + registers[rs1] - DATA_START] << 32) + (data_section[imm + 5 + registers[rs1] - DATA_START] << 40);
-                    registers[rd] += (data_section[imm + 6 + registers[rs1] - DATA_START] << 48) + (data_section[imm + 7 + registers[rs1] - DATA_START] << 56);
-                }
-                else if(funct3 == 0x4){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START];
-                    registers[rd] = registers[rd] & 0xff;
-                }
-                else if(funct3 == 0x5){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START] + (data_section[imm + 1 + registers[rs1] - DATA_START] << 8);
-                    registers[rd] = registers[rd] & 0xffff;
-                }
-                else if(funct3 == 0x6){
-                    registers[rd] = data_section[imm + registers[rs1] - DATA_START] + (data_section[imm + 1 + registers[rs1] - DATA_START] << 8);
-                    registers[rd] += (data_section[imm + 2 + registers[rs1] - DATA_START] << 16) + (data_section[imm + 3 + registers[rs1] - DATA_START] << 24);
-                    registers[rd] = registers[rd] & 0xffffffff;
-                }
-            }
+            else registers[rd] = read_data_from_memory(address, funct3);
         }
         pc += 4;
     }
@@ -714,7 +653,7 @@ void execute_instruction(unsigned instruction){
         long long int imm = (instruction >> 20);
 
         if(imm & 0x800){
-            imm |= 0xfffff000;
+            imm |= ~0xfffLL;
         }
 
         if(rd != 0){
@@ -737,13 +676,17 @@ void execute_instruction(unsigned instruction){
 
         // Sign-extend the immediate (12 bits to 32 bits)
         if(imm & 0x800){  // Check if the sign bit (bit 11) is set
-            imm |= 0xfffff000;  // Sign-extend by filling the upper 20 bits with 1s
+            imm |= ~0xfffLL;  // Sign-extend by filling the upper 52 bits with 1s
         }
         long long address = registers[rs1] + imm;
+        last_mem_address = address;
+        if(vm_enabled && !timing_offloaded) vm_translate(address, VM_STORE);
         long long data = registers[rs2];
-        if(cache_enabled){
-            cache_accesses++;
+        if(cache_enabled && !timing_offloaded){
+            unsigned long long start = host_cache_timing ? host_ticks() : 0;
+            cache_access_pc = pc;
             cache_write(address, data, funct3);  // Attempt cache write
+            if(host_cache_timing) host_timer_add(HOST_CACHE, start);
         }
         else{
             if(funct3 == 0x0){  // SB (Store Byte)
@@ -784,7 +727,7 @@ void execute_instruction(unsigned instruction){
         unsigned rs2 = (instruction >> 20) & 0x1f;
 
         // Immediate is a combination of different instruction fields
-        int imm = ((instruction >> 7) & 0x1E) | ((instruction >> 25) << 5) | ((instruction >> 8) & 0x1) | ((instruction & 0x80000000) ? 0xfffff000 : 0);
+        int imm = ((instruction >> 7) & 0x1E) | ((instruction >> 20) & 0x7e0) | ((instruction << 4) & 0x800) | ((instruction & 0x80000000) ? 0xfffff000 : 0);
 
         if(funct3 == 0x0){  // BEQ
             if(registers[rs1] == registers[rs2]) pc += imm;    // Take the branch
@@ -803,11 +746,11 @@ void execute_instruction(unsigned instruction){
             else pc += 4;
         }
         else if(funct3 == 0x6){  // BLTU (unsigned comparison)
-            if((unsigned int)registers[rs1] < (unsigned int)registers[rs2]) pc += imm;
+            if((unsigned long long)registers[rs1] < (unsigned long long)registers[rs2]) pc += imm;
             else pc += 4;
         }
         else if(funct3 == 0x7){  // BGEU (unsigned comparison)
-            if((unsigned int)registers[rs1] >= (unsigned int)registers[rs2]) pc += imm;
+            if((unsigned long long)registers[rs1] >= (unsigned long long)registers[rs2]) pc += imm;
             else pc += 4;
         }
     }
@@ -827,46 +770,150 @@ void execute_instruction(unsigned instruction){
         // Update pc with the jump target address
         pc += imm;
 
-        for(int i=0;i<64;i++){
-            if(labels[i].address == pc){
-                push_stack(labels[i].name, 0);
-                break;
-            }
+        int label_id = label_at_address(pc);
+        if(label_id >= 0) push_stack(label_id);
+    }
+    else if(instruction == 0x00000073){     // ecall, there is no operating system so it ends the program like exit
+        pc = instr_count * 4;
+    }
+    else if(opcode == 0x73){  // Zicsr, every implemented CSR is a read-only counter
+        unsigned funct3 = (instruction >> 12) & 0x7;
+        unsigned rd = (instruction >> 7) & 0x1f;
+        unsigned rs1 = (instruction >> 15) & 0x1f;     // Register or 5-bit immediate
+        unsigned csr = instruction >> 20;
+        long long value;
+        // csrrw always writes, csrrs and csrrc (and their i forms) only with a non-zero source
+        int writes = (funct3 & 0x3) == 0x1 || rs1 != 0;
+        if((funct3 & 0x3) == 0 || !read_csr(csr, &value)){
+            printf("Error: Unsupported system instruction 0x%08x at PC 0x%x\n", instruction, pc);
+            pc = instr_count * 4;
+        }
+        else if(writes){
+            printf("Error: CSR 0x%03x is read-only, write at PC 0x%x\n", csr, pc);
+            pc = instr_count * 4;
         }
+        else{
+            if(rd != 0) registers[rd] = value;
+            pc += 4;
+        }
+    }
+    else{   // Stopping on opcodes the executor does not implement instead of spinning on the same pc
+        printf("Error: Unsupported instruction 0x%08x at PC 0x%x\n", instruction, pc);
+        pc = instr_count * 4;
     }
 }
+// Function to execute the instruction at pc and hand it to the timing models
+void step_instruction(){
+    if(roi_enabled) roi_marker(text_section[pc / 4]);
+    if(timing_thread_enabled && timing_thread_eligible()){
+        unsigned current_pc = pc, instruction = text_section[pc / 4];
+        if(!timing_offloaded) timing_start_offload();
+        execute_instruction(instruction);
+        instret++;
+        timing_push(current_pc, pc, instruction, last_mem_address);
+        return;
+    }
+    if(!pipeline_enabled && !ooo_enabled && !branch_predictor_enabled && !profiling_enabled && !intervals_enabled && !vm_enabled){
+        execute_instruction(text_section[pc / 4]);
+        instret++;
+        return;
+    }
+    retired_instr retired;
+    retired.pc = pc;
+    retired.instruction = text_section[pc / 4];
+    long long hits_before = cache_hits, misses_before = cache_misses, stall_before = dram_stall_cycles;
+    vm_marker translation_before = vm_mark();
+    if(vm_enabled && vm_settings.translate_fetch) vm_translate(pc, VM_FETCH);
+    execute_instruction(retired.instruction);
+    instret++;
+    retired.next_pc = pc;
+    retired.mem_address = last_mem_address;
+    retired.cache_hits = cache_hits - hits_before;
+    retired.cache_misses = cache_misses - misses_before;
+    retired.memory_cycles = dram_stall_cycles - stall_before;
+    retired.itlb_cycles = retired.dtlb_cycles = 0;
+    if(vm_enabled) vm_account(&retired, &translation_before);
+    retired.mispredicted = branch_predictor_enabled ? predict_branch(&retired) : retired.next_pc != retired.pc + 4;
+    if(pipeline_enabled) pipeline_retire(&retired);
+    if(ooo_enabled) ooo_retire(&retired);
+    if(profiling_enabled) profile_retire(&retired);
+    if(intervals_enabled) interval_retire(&retired);
+}
 // Function to execute all pending instructions
 void run(){
     printf("Running program...\n");
     int sen = 0;
     int break_pt = 0;
+    unsigned long long start = host_ticks();
     while(pc < instr_count * 4){
         unsigned current_pc = pc;
-        if(break_points[current_pc / 4 - 1]){
+        if(break_points[current_pc / 4]){
             break_pt = 1;
             break;
         }
         else{
             call_stack[stack_top].line_num = instruction_lines[current_pc / 4];
-            execute_instruction(text_section[pc / 4]);
-            printf("Executed instruction: %s PC = 0x%016lx\n", instructions[current_pc / 4], (long unsigned)current_pc);
+            step_instruction();
+            host_events.instructions++;
+            unsigned long long output_start = host_ticks();
+            host_events.trace_bytes += printf("Executed instruction: %s PC = 0x%016lx\n", instructions[current_pc / 4], (long unsigned)current_pc);
+            host_timer_add(HOST_OUTPUT, output_start);
         }
     }
+    timing_drain();
+    host_timer_add(HOST_RUN, start);
     if(break_pt) printf("Execution stopped at break point\n");
     if((pc - TEXT_START) / 4 >= instr_count) sen = 1;
     if(sen){
         pop_stack();
-        printf("%d %d %d\n", cache_accesses, cache_hits, cache_misses);
+        printf("%lld %lld %lld\n", cache_accesses, cache_hits, cache_misses);
+        if(roi_enabled){
+            roi_finish();
+            print_roi_stats();
+        }
+        if(pipeline_enabled) print_pipeline_stats();
+        if(ooo_enabled) print_ooo_stats();
+        if(branch_predictor_enabled) print_branch_stats();
+        if(prefetcher_enabled && cache_enabled) print_prefetch_stats();
+        if(victim_cache_enabled && cache_enabled) print_victim_cache_stats();
+        if(write_buffer_enabled && cache_enabled) print_write_buffer_stats();
+        if(miss_classifier_enabled && cache_enabled) print_miss_classes(MISS_TOP);
+        if(dram_enabled && cache_enabled) print_dram_stats();
+        if(vm_enabled) print_vm_stats();
+        if(intervals_enabled){
+            interval_flush();   // The last interval is usually shorter
+            print_interval_stats();
+        }
     }
     else if(!break_pt) printf("No more instructions left to execute\n");
 }
+// Function to execute up to count instructions without printing, used by the fast paths
+long long run_quiet(long long count){
+    long long executed = 0;
+    unsigned long long start = host_ticks();
+    while(executed < count && pc < instr_count * 4){
+        if(stack_top >= 0) call_stack[stack_top].line_num = instruction_lines[pc / 4];
+        step_instruction();
+        executed++;
+    }
+    timing_drain();
+    host_timer_add(HOST_RUN, start);
+    host_events.instructions += executed;
+    return executed;
+}
 // Function to execute current instruction
 void step(){
     if(pc < 0x10000 && (pc - TEXT_START) / 4 < instr_count){
         unsigned current_pc = pc;
+        unsigned long long start = host_ticks();
         call_stack[stack_top].line_num = instruction_lines[current_pc / 4];
-        execute_instruction(text_section[pc / 4]);
-        printf("Executed instruction: %s PC = 0x%016lx\n", instructions[current_pc / 4], (long unsigned)current_pc);
+        step_instruction();
+        timing_drain();
+        host_events.instructions++;
+        unsigned long long output_start = host_ticks();
+        host_events.trace_bytes += printf("Executed instruction: %s PC = 0x%016lx\n", instructions[current_pc / 4], (long unsigned)current_pc);
+        host_timer_add(HOST_OUTPUT, output_start);
+        host_timer_add(HOST_RUN, start);
         if((pc - TEXT_START) / 4 >= instr_count){
             pop_stack();
         } 
@@ -882,6 +929,8 @@ void print_registers(){
 }
 // Function to end program
 void exit_simulator(){
+    if(profiling_enabled) print_profile(PROFILE_TOP);
+    print_host_stats();
     printf("Exiting simulator.\n");
     exit(0);
 }
@@ -906,8 +955,8 @@ void print_mem_at_address(unsigned start_address, unsigned count){
 }
 // Function to handle all input commands from user
 void handle_command(char *command){
-    char cmd[strlen(command)];
-    char command_copy[strlen(command)];
+    char cmd[strlen(command) + 1];
+    char command_copy[strlen(command) + 1];
     strcpy(command_copy, command);
     sscanf(command, "%s", cmd);
     if(strcmp(cmd, "load") == 0){
@@ -928,8 +977,6 @@ void handle_command(char *command){
             unsigned int address, count;
             sscanf(command + strlen(cmd), "%x %u", &address, &count);
             print_mem_at_address(address, count);
-            free(address_str);
-            free(count_str);
         }
     }
     else if(strcmp(cmd, "break") == 0){
@@ -938,8 +985,12 @@ void handle_command(char *command){
         if(break_line == NULL) printf("Missing arguments\n");
         else{
             int break_line_num = atoi(break_line);
-            if(break_line_num > 0) break_points[break_line_num - 1] = 1;
-            fprintf(stdout, "Break point set at line %d\n", break_line_num);
+            int index = break_line_num > 0 ? instruction_at_line(break_line_num) : -1;     // Break points are kept per instruction
+            if(index < 0) printf("Error: No instruction at or after line %d\n", break_line_num);
+            else{
+                break_points[index] = 1;
+                fprintf(stdout, "Break point set at line %d\n", instruction_lines[index]);
+            }
         }
     }
     else if(strcmp(cmd, "delete") == 0 || strcmp(cmd, "del") == 0){
@@ -949,12 +1000,165 @@ void handle_command(char *command){
         if(break_line == NULL || if_break == NULL) printf("Missing arguments\n");
         else{
             int break_line_num = atoi(break_line);
-            if(break_points[break_line_num - 1]){
-                if(break_line_num > 0) break_points[break_line_num - 1] = 0;
+            int index = break_line_num > 0 ? instruction_at_line(break_line_num) : -1;
+            if(index >= 0 && instruction_lines[index] == break_line_num && break_points[index]){
+                break_points[index] = 0;
             }
             else fprintf(stdout, "No break point found at line %d\n", break_line_num);
         }
     }
+    else if(strcmp(cmd, "pipeline") == 0){
+        char operation[10], config_file[256];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %255s", operation, config_file);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_pipeline(parsed_items == 2 ? config_file : NULL);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_pipeline();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_pipeline_stats();
+        else printf("Usage: pipeline <enable/disable/stats> [config_file]\n");
+    }
+    else if(strcmp(cmd, "dram") == 0){
+        char operation[10], config_file[256];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %255s", operation, config_file);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_dram(parsed_items == 2 ? config_file : NULL);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_dram();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_dram_stats();
+        else printf("Usage: dram <enable/disable/stats> [config_file]\n");
+    }
+    else if(strcmp(cmd, "vm") == 0){
+        char operation[10], config_file[256];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %255s", operation, config_file);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_vm(parsed_items == 2 ? config_file : NULL);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_vm();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_vm_stats();
+        else printf("Usage: vm <enable/disable/stats> [config_file]\n");
+    }
+    else if(strcmp(cmd, "ooo") == 0){
+        char operation[10], config_file[256];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %255s", operation, config_file);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_ooo(parsed_items == 2 ? config_file : NULL);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_ooo();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_ooo_stats();
+        else printf("Usage: ooo <enable/disable/stats> [config_file]\n");
+    }
+    else if(strcmp(cmd, "branch_sim") == 0){
+        char operation[10], kind[16];
+        int bits = 12;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %15s %d", operation, kind, &bits);
+        if(parsed_items >= 2 && strcmp(operation, "enable") == 0) enable_branch_predictor(kind, bits);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_branch_predictor();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_branch_stats();
+        else printf("Usage: branch_sim <enable/disable/stats> [static/bimodal/gshare/tournament/tage] [table_bits]\n");
+    }
+    else if(strcmp(cmd, "prefetch") == 0){
+        char operation[10], kind[16];
+        int degree = 2, distance = 1, latency = 8;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %15s %d %d %d", operation, kind, &degree, &distance, &latency);
+        if(parsed_items >= 2 && strcmp(operation, "enable") == 0) enable_prefetcher(kind, degree, distance, latency);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_prefetcher();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_prefetch_stats();
+        else printf("Usage: prefetch <enable/disable/stats> [nextline/stride/stream/delta] [degree] [distance] [latency]\n");
+    }
+    else if(strcmp(cmd, "victim_cache") == 0){
+        char operation[10];
+        int entries = 8;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %d", operation, &entries);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_victim_cache(entries);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_victim_cache();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_victim_cache_stats();
+        else printf("Usage: victim_cache <enable/disable/stats> [lines]\n");
+    }
+    else if(strcmp(cmd, "write_buffer") == 0){
+        char operation[10];
+        int entries = 8;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %d", operation, &entries);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_write_buffer(entries);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_write_buffer();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_write_buffer_stats();
+        else printf("Usage: write_buffer <enable/disable/stats> [entries]\n");
+    }
+    else if(strcmp(cmd, "miss_class") == 0){
+        char operation[10];
+        int top = MISS_TOP;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %d", operation, &top);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_miss_classifier();
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_miss_classifier();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_miss_classes(top);
+        else printf("Usage: miss_class <enable/disable/stats> [top]\n");
+    }
+    else if(strcmp(cmd, "intervals") == 0){
+        char operation[10], interval_filename[100];
+        long long length = 0;
+        double threshold = PHASE_THRESHOLD;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %lld %99s %lf", operation, &length, interval_filename, &threshold);
+        if(parsed_items >= 3 && strcmp(operation, "enable") == 0) enable_intervals(length, interval_filename, threshold);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_intervals();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_interval_stats();
+        else printf("Usage: intervals <enable/disable/stats> [instructions] [file_name] [phase_threshold]\n");
+    }
+    else if(strcmp(cmd, "heatmap") == 0){
+        char operation[10], argument[100];
+        unsigned start = 0, end = 0;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %99s %x %x", operation, argument, &start, &end);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_heatmap();
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_heatmap();
+        else if(parsed_items >= 1 && strcmp(operation, "show") == 0) print_heatmap(parsed_items >= 2 ? atoi(argument) : HEATMAP_TOP);
+        else if(parsed_items >= 2 && strcmp(operation, "csv") == 0) write_heatmap_csv(argument);
+        else if(parsed_items == 4 && strcmp(operation, "region") == 0) add_heat_region(argument, start, end);
+        else printf("Usage: heatmap <enable/disable/show/csv/region> [top | file_name | name start end]\n");
+    }
+    else if(strcmp(cmd, "profile") == 0){
+        char operation[10];
+        int top = PROFILE_TOP;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %d", operation, &top);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_profiling();
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_profiling();
+        else if(parsed_items >= 1 && strcmp(operation, "report") == 0) print_profile(top);
+        else printf("Usage: profile <enable/disable/report> [count]\n");
+    }
+    else if(strcmp(cmd, "timing_thread") == 0){
+        char operation[10];
+        int batch = TIMING_BATCH;
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %d", operation, &batch);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_timing_thread(batch);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_timing_thread();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_timing_thread_stats();
+        else printf("Usage: timing_thread <enable/disable/stats> [batch]\n");
+    }
+    else if(strcmp(cmd, "roi") == 0){
+        char operation[10], option[10];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %9s", operation, option);
+        if(parsed_items >= 1 && strcmp(operation, "enable") == 0) enable_roi(parsed_items == 2 && strcmp(option, "warm") == 0);
+        else if(parsed_items >= 1 && strcmp(operation, "disable") == 0) disable_roi();
+        else if(parsed_items >= 1 && strcmp(operation, "stats") == 0) print_roi_stats();
+        else printf("Usage: roi <enable/disable/stats> [warm]\n");
+    }
+    else if(strcmp(cmd, "stats") == 0){
+        char group[10], operation[10], option[10];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %9s %9s", group, operation, option);
+        if(parsed_items == 1 && strcmp(group, "host") == 0) print_host_stats();
+        else if(parsed_items == 2 && strcmp(group, "host") == 0 && strcmp(operation, "reset") == 0) host_stats_reset();
+        else if(parsed_items == 3 && strcmp(group, "host") == 0 && strcmp(operation, "cache") == 0 && strcmp(option, "on") == 0) host_cache_timing = 1;
+        else if(parsed_items == 3 && strcmp(group, "host") == 0 && strcmp(operation, "cache") == 0 && strcmp(option, "off") == 0) host_cache_timing = 0;
+        else printf("Usage: stats host [reset | cache <on/off>]\n");
+    }
+    else if(strcmp(cmd, "bench") == 0){
+        char manifest[256] = BENCH_MANIFEST;
+        sscanf(command + strlen(cmd), "%255s", manifest);
+        run_benchmarks(manifest);
+    }
+    else if(strcmp(cmd, "sample") == 0){
+        long long fast_forward, warmup, detail;
+        if(sscanf(command + strlen(cmd), "%lld %lld %lld", &fast_forward, &warmup, &detail) == 3 && fast_forward >= 0 && warmup >= 0 && detail > 0){
+            sample_run(fast_forward, warmup, detail);
+        }
+        else printf("Usage: sample <fast_forward> <warmup> <detail>\n");
+    }
+    else if(strcmp(cmd, "checkpoint") == 0){
+        char operation[10], checkpoint_file[256];
+        int parsed_items = sscanf(command + strlen(cmd), "%9s %255s", operation, checkpoint_file);
+        if(parsed_items == 2 && strcmp(operation, "save") == 0) save_checkpoint(checkpoint_file);
+        else if(parsed_items == 2 && strcmp(operation, "load") == 0) load_checkpoint(checkpoint_file);
+        else printf("Usage: checkpoint <save/load> <file_name>\n");
+    }
     else if(strcmp(cmd, "cache_sim") == 0){
         char operation[10], filename[256];
         int parsed_items = sscanf(command + strlen(cmd), "%s %s", operation, filename);
@@ -992,6 +1196,7 @@ void handle_command(char *command){
 int main(){ 
     char command[256];
 
+    host_stats_init();
     printf("RISC-V Simulator\n");
     while(1){
         printf("> ");
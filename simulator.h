@@ -0,0 +1,68 @@
+#include "assembler.h"
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+// Simulator state shared with the other modules
+extern unsigned text_section[DATA_START / 4];
+extern long long int data_section[STACK_START - DATA_START];
+
+extern long long int registers[NUM_REGS];
+extern unsigned pc;
+extern unsigned stack_pointer;
+
+extern int instr_count;
+extern long long instret;
+
+extern char instructions[MAX_INSTRS][MAX_LINE_LEN];
+extern int instruction_lines[MAX_INSTRS];
+
+#define MAIN_FRAME -1             // Label ID of the frame the program starts in
+#define MAX_CALL_DEPTH (1 << 20)  // Deeper recursion is reported as a stack overflow
+
+typedef struct call_frame{
+    int label_id;                   // Index into labels[], MAIN_FRAME for the entry frame
+    int line_num;
+    long long entry_instructions;   // Profiler counters when the frame was entered
+    long long entry_misses;
+} call_frame;
+
+extern call_frame* call_stack;
+extern int stack_top;
+extern int break_points[MAX_INSTRS];
+
+typedef struct{
+    unsigned pc;            // Address of the instruction
+    unsigned next_pc;       // Address executed after it
+    unsigned instruction;
+    unsigned mem_address;   // Effective address, only meaningful for loads and stores
+    int cache_hits;         // Hits and misses the instruction caused in the cache model
+    int cache_misses;
+    int memory_cycles;      // Cycles the misses waited on main memory, only counted by the DRAM model
+    int itlb_cycles;        // Fetch and data translation cycles beyond an L1 TLB hit, only with Sv39 translation
+    int dtlb_cycles;
+    int mispredicted;       // 1 if fetch went down the wrong path, every taken branch without a branch predictor
+} retired_instr;
+
+typedef struct{
+    int rd, rs1, rs2;       // Registers written and read, 0 when unused
+    int is_load;
+    int is_store;
+    int is_control;         // Branches and jumps
+    int is_multiply;        // RV64M mul, mulh, mulhsu, mulhu and mulw
+    int is_divide;          // RV64M div, divu, rem, remu and their word forms
+} instr_info;
+
+instr_info decode_operands(unsigned instruction);
+void execute_instruction(unsigned instruction);
+void step_instruction();
+long long run_quiet(long long count);
+void load(char* filename);
+void index_labels();
+int label_at_address(unsigned address);
+const char* frame_name(int label_id);
+void push_stack(int label_id);
+void pop_stack();
+void reset();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include<stdatomic.h>
+#include<pthread.h>
+#include<sched.h>
+#include<time.h>
+#include "simulator.h"
+#include "cache.h"
+#include "pipeline.h"
+#include "ooo.h"
+#include "branch_predictor.h"
+#include "profiler.h"
+#include "roi.h"
+#include "timing_thread.h"
+#include "intervals.h"
+#include "dram.h"
+#include "vm.h"
+
+/*
+The interpreter thread executes instructions functionally, reading and writing memory directly,
+and pushes one record per retired instruction into a single-producer/single-consumer ring
+The timing thread replays the records through the cache tags, the branch predictor and the timing models
+Both sides move their ring position in batches so the shared cache lines bounce once per batch
+Memory holds all data while offloaded, so dirty cache data is copied out when offloading starts
+and the cache blocks are refreshed from memory on every drain
+While nothing is offloaded the timing thread sleeps on a condition variable instead of polling
+*/
+int timing_thread_enabled = 0;
+int timing_offloaded = 0;       // 1 while the cache model is being driven by the timing thread
+int timing_batch = TIMING_BATCH;
+
+timing_record ring[TIMING_RING_SIZE];
+_Alignas(64) atomic_ulong ring_tail;    // Records published by the interpreter
+_Alignas(64) atomic_ulong ring_head;    // Records finished by the timing thread
+_Alignas(64) atomic_int stop_consumer;
+_Alignas(64) atomic_int producer_active;   // 1 while records may arrive, the consumer parks otherwise
+pthread_mutex_t park_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t park_signal = PTHREAD_COND_INITIALIZER;
+
+// Interpreter-side positions, only touched by the producer
+unsigned long write_index = 0;
+unsigned long cached_head = 0;
+
+pthread_t consumer_thread;
+int consumer_running = 0;
+timing_thread_stats thread_stats;
+atomic_llong consumer_waits;     // Times the timing thread found the ring empty, counted by the timing thread
+
+// Function to give up the processor while waiting, sleeping once a wait has gone on for a while
+void wait_a_little(int* spins){
+    if(++*spins < 64) sched_yield();
+    else{
+        struct timespec pause = {0, 20000};
+        nanosleep(&pause, NULL);
+    }
+}
+
+// Function to run one record through the models, the same way step_instruction() does inline
+void replay_record(timing_record* record){
+    retired_instr retired;
+    retired.pc = record->pc;
+    retired.next_pc = record->next_pc;
+    retired.instruction = record->instruction;
+    retired.mem_address = record->mem_address;
+    instr_info info = decode_operands(record->instruction);
+    long long hits_before = cache_hits, misses_before = cache_misses, stall_before = dram_stall_cycles;
+    vm_marker translation_before = vm_mark();
+    if(vm_enabled){     // Translation runs ahead of the access, the same as inline
+        if(vm_settings.translate_fetch) vm_translate(record->pc, VM_FETCH);
+        if(info.is_load || info.is_store) vm_translate(record->mem_address, info.is_store ? VM_STORE : VM_LOAD);
+    }
+    if(cache_enabled && ((info.is_load && info.rd != 0) || info.is_store)){    // Loads into x0 never reach the cache
+        cache_access_pc = record->pc;
+        cache_probe(record->mem_address, 1 << ((record->instruction >> 12) & 0x3), info.is_store);
+    }
+    retired.cache_hits = cache_hits - hits_before;
+    retired.cache_misses = cache_misses - misses_before;
+    retired.memory_cycles = dram_stall_cycles - stall_before;
+    retired.itlb_cycles = retired.dtlb_cycles = 0;
+    if(vm_enabled) vm_account(&retired, &translation_before);
+    retired.mispredicted = branch_predictor_enabled ? predict_branch(&retired) : retired.next_pc != retired.pc + 4;
+    if(pipeline_enabled) pipeline_retire(&retired);
+    if(ooo_enabled) ooo_retire(&retired);
+}
+
+// Function to set whether records may arrive, waking the timing thread when they may
+void set_producer_active(int active){
+    pthread_mutex_lock(&park_lock);
+    atomic_store_explicit(&producer_active, active, memory_order_release);
+    if(active) pthread_cond_signal(&park_signal);
+    pthread_mutex_unlock(&park_lock);
+}
+
+// Function to sleep while the interpreter is not offloading and the thread is not asked to stop
+void park_consumer(){
+    pthread_mutex_lock(&park_lock);
+    while(!atomic_load_explicit(&producer_active, memory_order_acquire) && !atomic_load_explicit(&stop_consumer, memory_order_acquire)){
+        pthread_cond_wait(&park_signal, &park_lock);
+    }
+    pthread_mutex_unlock(&park_lock);
+}
+
+// Consumer loop of the timing thread
+void* timing_consumer(void* unused){
+    (void)unused;
+    unsigned long head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    int spins = 0;
+    while(1){
+        unsigned long tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+        if(head == tail){
+            if(atomic_load_explicit(&stop_consumer, memory_order_acquire)) break;
+            if(!atomic_load_explicit(&producer_active, memory_order_acquire)){
+                park_consumer();    // Every record was published before the producer went idle
+                spins = 0;
+                continue;
+            }
+            atomic_fetch_add_explicit(&consumer_waits, 1, memory_order_relaxed);
+            wait_a_little(&spins);
+            continue;
+        }
+        spins = 0;
+        while(head != tail){
+            unsigned long end = (tail - head > (unsigned long)timing_batch) ? head + timing_batch : tail;
+            for(; head != end; head++) replay_record(&ring[head & (TIMING_RING_SIZE - 1)]);
+            atomic_store_explicit(&ring_head, head, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+// Function to make the records written so far visible to the timing thread
+void publish_records(){
+    atomic_store_explicit(&ring_tail, write_index, memory_order_release);
+    thread_stats.batches++;
+}
+
+// Function to decide whether the models can run on the timing thread
+int timing_thread_eligible(){
+    // The profiler follows the call stack and region markers switch models mid-run, both stay inline
+    // Interval snapshots read the model counters at instruction boundaries, so they stay inline too
+    if(!timing_thread_enabled || profiling_enabled || roi_enabled || intervals_enabled) return 0;
+    return cache_enabled || pipeline_enabled || ooo_enabled || branch_predictor_enabled;
+}
+
+// Function to switch the interpreter to memory and the models to the timing thread
+void timing_start_offload(){
+    // The interpreter reads and writes memory directly from now on, so memory has to hold what the cache holds
+    if(cache_enabled) publish_cache_to_memory();
+    timing_offloaded = 1;
+    set_producer_active(1);
+}
+
+// Function to hand a retired instruction to the timing thread, waiting while the ring is full
+void timing_push(unsigned pc, unsigned next_pc, unsigned instruction, unsigned mem_address){
+    if(!consumer_running){
+        atomic_store(&stop_consumer, 0);
+        if(pthread_create(&consumer_thread, NULL, timing_consumer, NULL) != 0){
+            printf("Error: Cannot start the timing thread, running the models inline\n");
+            timing_thread_enabled = 0;
+            timing_offloaded = 0;
+            return;
+        }
+        consumer_running = 1;
+    }
+    if(write_index - cached_head == TIMING_RING_SIZE){
+        publish_records();
+        cached_head = atomic_load_explicit(&ring_head, memory_order_acquire);
+        int spins = 0;
+        while(write_index - cached_head == TIMING_RING_SIZE){
+            thread_stats.producer_stalls++;
+            wait_a_little(&spins);
+            cached_head = atomic_load_explicit(&ring_head, memory_order_acquire);
+        }
+    }
+    timing_record* record = &ring[write_index & (TIMING_RING_SIZE - 1)];
+    record->pc = pc;
+    record->next_pc = next_pc;
+    record->instruction = instruction;
+    record->mem_address = mem_address;
+    write_index++;
+    thread_stats.records++;
+    if(write_index % timing_batch == 0) publish_records();
+}
+
+// Function to wait until the timing thread has replayed every record, so the model state is current
+void timing_drain(){
+    if(!timing_offloaded) return;
+    if(consumer_running){
+        publish_records();
+        int spins = 0;
+        while(atomic_load_explicit(&ring_head, memory_order_acquire) != write_index) wait_a_little(&spins);
+        cached_head = write_index;
+        thread_stats.drains++;
+    }
+    if(cache_enabled) sync_cache_from_memory();     // The timing thread only moved tags
+    timing_offloaded = 0;
+    set_producer_active(0);
+}
+
+// Function to stop and join the timing thread
+void stop_timing_thread(){
+    timing_drain();
+    if(!consumer_running) return;
+    pthread_mutex_lock(&park_lock);
+    atomic_store_explicit(&stop_consumer, 1, memory_order_release);
+    pthread_cond_signal(&park_signal);
+    pthread_mutex_unlock(&park_lock);
+    pthread_join(consumer_thread, NULL);
+    consumer_running = 0;
+}
+
+void enable_timing_thread(int batch){
+    if(batch <= 0 || batch > TIMING_RING_SIZE / 2){
+        printf("Error: Batch size must be between 1 and %d\n", TIMING_RING_SIZE / 2);
+        return;
+    }
+    stop_timing_thread();   // The batch size is read by the running consumer
+    timing_batch = batch;
+    timing_thread_enabled = 1;
+    memset(&thread_stats, 0, sizeof(thread_stats));
+    atomic_store(&consumer_waits, 0);
+    printf("Timing thread enabled (batch %d, ring %d records).\n", batch, TIMING_RING_SIZE);
+}
+
+void disable_timing_thread(){
+    stop_timing_thread();
+    timing_thread_enabled = 0;
+    printf("Timing thread disabled.\n");
+}
+
+void print_timing_thread_stats(){
+    if(!timing_thread_enabled){
+        printf("Timing thread is disabled.\n");
+        return;
+    }
+    printf("Timing thread statistics:\n");
+    printf("Records replayed: %lld in %lld batches\n", thread_stats.records, thread_stats.batches);
+    printf("Interpreter stalls on a full ring: %lld\n", thread_stats.producer_stalls);
+    printf("Timing thread waits on an empty ring: %lld\n", (long long)atomic_load_explicit(&consumer_waits, memory_order_relaxed));
+    printf("Drains: %lld\n", thread_stats.drains);
+}
\ No newline at end of file
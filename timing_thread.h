@@ -0,0 +1,37 @@
+#include <stdio.h>
+
+#ifndef TIMING_THREAD_H
+#define TIMING_THREAD_H
+
+#include "simulator.h"
+
+#define TIMING_RING_SIZE (1 << 16)      // Records in flight between the two threads, a power of two
+#define TIMING_BATCH 256                // Records published or consumed at a time
+
+// What the timing thread needs to know about a retired instruction
+typedef struct{
+    unsigned pc;
+    unsigned next_pc;
+    unsigned instruction;
+    unsigned mem_address;
+} timing_record;
+
+typedef struct{
+    long long records;          // Records handed to the timing thread
+    long long batches;          // Times the producer published its position
+    long long producer_stalls;  // Times the ring was full and the interpreter had to wait
+    long long drains;           // Times the interpreter waited for the timing thread to catch up
+} timing_thread_stats;
+
+extern int timing_thread_enabled;
+extern int timing_offloaded;
+
+void enable_timing_thread(int batch);
+void disable_timing_thread();
+int timing_thread_eligible();
+void timing_start_offload();
+void timing_push(unsigned pc, unsigned next_pc, unsigned instruction, unsigned mem_address);
+void timing_drain();
+void print_timing_thread_stats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include<stdio.h>  // Necessary header files imported
+#include<stdlib.h>
+#include<string.h>
+#include "simulator.h"
+#include "cache.h"
+#include "dram.h"
+#include "timing_thread.h"
+#include "vm.h"
+
+/*
+Sv39 translation for loads and stores, and for instruction fetches if the config asks for it
+The loader maps all of memory one to one with pages of the configured size, text pages read and execute,
+data and stack pages read and write, so translation never changes what a program computes, only its timing
+The page tables live in their own memory right above data memory, and the walker reads every PTE
+through the data cache model, so walks compete with the program for cache space
+Each side has an L1 TLB, both miss into a shared L2 TLB, and an L2 miss walks the three levels from the root
+*/
+int vm_enabled = 0;
+vm_config vm_settings = {16, 4, 512, 4, 6, 4096, 1, 100, 0};
+unsigned char page_table_memory[PAGE_TABLE_SIZE];
+
+typedef struct{
+    int valid;
+    unsigned long long page;    // Virtual page number at the configured page size
+    int permissions;            // R, W and X bits of the leaf PTE
+    long long last_use;
+} tlb_entry;
+
+typedef struct{
+    int sets;
+    int ways;
+    tlb_entry* entries;
+} tlb;
+
+tlb itlb, dtlb, l2_tlb;
+tlb_stats itlb_stats, dtlb_stats;
+walk_stats walk;
+long long tlb_clock = 0;
+int page_shift = PAGE_SHIFT;
+int leaf_level = 0;         // Page table level of the leaves, 0 for 4 KiB, 1 for 2 MiB and 2 for 1 GiB pages
+
+// Function to read the virtual memory parameters, one per line in the order of vm_config
+int read_vm_config(char* config_file, vm_config* config){
+    FILE* fptr = fopen(config_file, "r");
+    if(fptr == NULL){
+        perror("Error opening file");
+        return 0;
+    }
+    char buffer[50];
+    int line_num = 0;
+    int* fields[9] = {&config->l1_entries, &config->l1_ways, &config->l2_entries, &config->l2_ways, &config->l2_latency,
+                      &config->page_size, &config->pte_latency, &config->memory_latency, &config->translate_fetch};
+
+    while(fgets(buffer, sizeof(buffer), fptr)){
+        buffer[strcspn(buffer, "\n")] = 0;
+        if(line_num < 9) *fields[line_num] = atoi(buffer);
+        else if(buffer[0] != '\0') printf("Unexpected line in configuration file\n");
+        line_num++;
+    }
+    fclose(fptr);
+    int page_ok = config->page_size == 4096 || config->page_size == (1 << 21) || config->page_size == (1 << 30);
+    if(config->l1_entries < 1 || config->l1_ways < 1 || config->l1_entries % config->l1_ways != 0 ||
+       config->l2_entries < 0 || (config->l2_entries > 0 && (config->l2_ways < 1 || config->l2_entries % config->l2_ways != 0)) ||
+       config->l2_latency < 0 || !page_ok || config->pte_latency < 0 || config->memory_latency < 0){
+        printf("Error: Invalid virtual memory configuration in %s\n", config_file);
+        return 0;
+    }
+    return 1;
+}
+
+// Function to write one PTE into the page table memory
+void write_pte(unsigned table, int index, unsigned long long pte){
+    for(int i = 0; i < PTE_SIZE; i++){
+        page_table_memory[table - PAGE_TABLE_BASE + index * PTE_SIZE + i] = (pte >> (8 * i)) & 0xff;
+    }
+}
+
+// Function to make a PTE pointing at a physical address
+unsigned long long make_pte(unsigned long long physical, int flags){
+    return (physical >> PAGE_SHIFT) << 10 | flags | PTE_V;
+}
+
+// Function to build the page tables that map memory one to one with pages of the configured size
+void build_page_tables(){
+    memset(page_table_memory, 0, sizeof(page_table_memory));
+    unsigned root = PAGE_TABLE_BASE, middle = root + (1 << PAGE_SHIFT), leaves = middle + (1 << PAGE_SHIFT);
+    int all = PTE_R | PTE_W | PTE_X | PTE_A | PTE_D;   // A superpage covers text and data alike
+    if(leaf_level == 2){
+        write_pte(root, 0, make_pte(0, all));
+        return;
+    }
+    write_pte(root, 0, make_pte(middle, 0));
+    if(leaf_level == 1){
+        write_pte(middle, 0, make_pte(0, all));
+        return;
+    }
+    write_pte(middle, 0, make_pte(leaves, 0));
+    for(unsigned page = 0; page < STACK_START >> PAGE_SHIFT; page++){
+        int flags = (page < DATA_START >> PAGE_SHIFT) ? PTE_R | PTE_X | PTE_A : PTE_R | PTE_W | PTE_A | PTE_D;
+        write_pte(leaves, page, make_pte((unsigned long long)page << PAGE_SHIFT, flags));
+    }
+}
+
+// Function to set up an empty TLB
+void tlb_init(tlb* buffer, int entries, int ways){
+    free(buffer->entries);
+    buffer->ways = ways;
+    buffer->sets = ways > 0 ? entries / ways : 0;
+    buffer->entries = calloc(entries > 0 ? entries : 1, sizeof(tlb_entry));
+}
+
+// Function to look a page up, returns its entry or NULL
+tlb_entry* tlb_lookup(tlb* buffer, unsigned long long page){
+    tlb_entry* set = &buffer->entries[(page % buffer->sets) * buffer->ways];
+    for(int i = 0; i < buffer->ways; i++){
+        if(set[i].valid && set[i].page == page){
+            set[i].last_use = tlb_clock++;
+            return &set[i];
+        }
+    }
+    return NULL;
+}
+
+// Function to insert a translation, replacing the least recently used entry of its set
+void tlb_insert(tlb* buffer, unsigned long long page, int permissions){
+    tlb_entry* set = &buffer->entries[(page % buffer->sets) * buffer->ways];
+    tlb_entry* victim = &set[0];
+    for(int i = 0; i < buffer->ways; i++){
+        if(!set[i].valid){
+            victim = &set[i];
+            break;
+        }
+        if(set[i].last_use < victim->last_use) victim = &set[i];
+    }
+    victim->valid = 1;
+    victim->page = page;
+    victim->permissions = permissions;
+    victim->last_use = tlb_clock++;
+}
+
+// Function to return the PTE bit an access needs
+int required_permission(vm_access kind){
+    if(kind == VM_FETCH) return PTE_X;
+    return kind == VM_STORE ? PTE_W : PTE_R;
+}
+
+// Function to time one page table read, it goes through the data cache when the cache model is on
+long long read_pte(unsigned pte_address){
+    long long cycles = vm_settings.pte_latency;
+    walk.pte_reads++;
+    if(!cache_enabled) return cycles + vm_settings.memory_latency;     // Every read goes to memory
+    long long hits_before = cache_hits, stall_before = dram_stall_cycles;
+    cache_walk_read(pte_address, !timing_offloaded);
+    long long waited = dram_stall_cycles - stall_before;
+    walk.memory_cycles += waited;
+    if(cache_hits > hits_before) walk.pte_hits++;
+    else{
+        walk.pte_misses++;
+        cycles += dram_enabled ? waited : vm_settings.memory_latency;
+    }
+    return cycles;
+}
+
+// Function to walk the page tables from the root, returns the leaf permissions or -1 on a page fault
+int page_walk(unsigned address, long long* cycles){
+    unsigned long long table = PAGE_TABLE_BASE;
+    walk.walks++;
+    for(int level = 2; level >= 0; level--){
+        unsigned long long pte_address = table + ((address >> (PAGE_SHIFT + 9 * level)) & (PTES_PER_TABLE - 1)) * PTE_SIZE;
+        if(pte_address < PAGE_TABLE_BASE || pte_address + PTE_SIZE > PAGE_TABLE_BASE + PAGE_TABLE_SIZE) return -1;
+        long long cost = read_pte(pte_address);
+        *cycles += cost;
+        walk.cycles += cost;
+        unsigned long long pte = 0;
+        for(int i = 0; i < PTE_SIZE; i++) pte |= (unsigned long long)page_table_memory[pte_address - PAGE_TABLE_BASE + i] << (8 * i);
+        if(!(pte & PTE_V)) return -1;
+        unsigned long long ppn = pte >> 10;
+        if(pte & (PTE_R | PTE_X)){
+            if(ppn & ((1ULL << (9 * level)) - 1)) return -1;    // Misaligned superpage
+            return pte & (PTE_R | PTE_W | PTE_X);
+        }
+        table = ppn << PAGE_SHIFT;
+    }
+    return -1;
+}
+
+// Function to translate one access, TLB misses and walks add to the stall cycles of its side
+void vm_translate(unsigned address, vm_access kind){
+    tlb* l1 = (kind == VM_FETCH) ? &itlb : &dtlb;
+    tlb_stats* stats = (kind == VM_FETCH) ? &itlb_stats : &dtlb_stats;
+    unsigned long long page = address >> page_shift;
+    int needed = required_permission(kind);
+    stats->accesses++;
+
+    tlb_entry* entry = tlb_lookup(l1, page);
+    if(entry){
+        stats->l1_hits++;
+        if(!(entry->permissions & needed)) stats->faults++;
+        return;
+    }
+    long long cycles = 0;
+    if(vm_settings.l2_entries > 0){
+        cycles += vm_settings.l2_latency;
+        entry = tlb_lookup(&l2_tlb, page);
+        if(entry){
+            stats->l2_hits++;
+            stats->stall_cycles += cycles;
+            tlb_insert(l1, page, entry->permissions);
+            if(!(entry->permissions & needed)) stats->faults++;
+            return;
+        }
+    }
+    stats->walks++;
+    int permissions = page_walk(address, &cycles);
+    stats->stall_cycles += cycles;
+    if(permissions < 0){       // Faulting translations are not cached
+        stats->faults++;
+        return;
+    }
+    if(vm_settings.l2_entries > 0) tlb_insert(&l2_tlb, page, permissions);
+    tlb_insert(l1, page, permissions);
+    if(!(permissions & needed)) stats->faults++;
+}
+
+// Function to take the counters an instruction is charged from
+vm_marker vm_mark(){
+    vm_marker marker = {walk.pte_hits, walk.pte_misses, walk.memory_cycles, itlb_stats.stall_cycles, dtlb_stats.stall_cycles};
+    return marker;
+}
+
+// Function to move the page table reads of an instruction out of its data accesses and into its translation cycles
+void vm_account(retired_instr* retired, vm_marker* before){
+    vm_marker now = vm_mark();
+    retired->cache_hits -= now.pte_hits - before->pte_hits;
+    retired->cache_misses -= now.pte_misses - before->pte_misses;
+    retired->memory_cycles -= now.memory_cycles - before->memory_cycles;
+    retired->itlb_cycles = now.itlb_cycles - before->itlb_cycles;
+    retired->dtlb_cycles = now.dtlb_cycles - before->dtlb_cycles;
+}
+
+// Function to rebuild the page tables and empty the TLBs and the statistics
+void vm_reset(){
+    page_shift = __builtin_ctz(vm_settings.page_size);
+    leaf_level = (page_shift - PAGE_SHIFT) / 9;
+    build_page_tables();
+    tlb_init(&itlb, vm_settings.l1_entries, vm_settings.l1_ways);
+    tlb_init(&dtlb, vm_settings.l1_entries, vm_settings.l1_ways);
+    tlb_init(&l2_tlb, vm_settings.l2_entries, vm_settings.l2_ways);
+    memset(&itlb_stats, 0, sizeof(itlb_stats));
+    memset(&dtlb_stats, 0, sizeof(dtlb_stats));
+    memset(&walk, 0, sizeof(walk));
+    tlb_clock = 0;
+}
+
+// Function to switch translation on, the parameters stay at their defaults without a config file
+void enable_vm(char* config_file){
+    vm_config config = {16, 4, 512, 4, 6, 4096, 1, 100, 0};
+    if(config_file != NULL && !read_vm_config(config_file, &config)) return;
+    vm_settings = config;
+    vm_reset();
+    vm_enabled = 1;
+    printf("Sv39 translation enabled: %d KiB pages, L1 TLBs %d entries %d-way, L2 TLB %d entries %d-way (%d cycles), %s\n",
+           config.page_size >> 10, config.l1_entries, config.l1_ways, config.l2_entries, config.l2_ways, config.l2_latency,
+           config.translate_fetch ? "loads, stores and fetches" : "loads and stores");
+}
+
+void disable_vm(){
+    vm_enabled = 0;
+    printf("Sv39 translation disabled\n");
+}
+
+// Function to print one TLB's line of statistics
+void print_tlb_line(const char* name, tlb_stats* stats){
+    printf("%s accesses: %lld, L1 hits: %lld, L2 hits: %lld, walks: %lld (miss rate %.4f), faults: %lld, stall cycles: %lld\n",
+           name, stats->accesses, stats->l1_hits, stats->l2_hits, stats->walks,
+           stats->accesses ? (double)stats->walks / stats->accesses : 0.0, stats->faults, stats->stall_cycles);
+}
+
+void print_vm_stats(){
+    if(!vm_enabled){
+        printf("Sv39 translation is disabled\n");
+        return;
+    }
+    if(vm_settings.translate_fetch) print_tlb_line("ITLB", &itlb_stats);
+    print_tlb_line("DTLB", &dtlb_stats);
+    printf("Page walks: %lld, PTE reads: %lld (cache hits %lld, misses %lld), walk cycles: %lld (%.2f per walk)\n",
+           walk.walks, walk.pte_reads, walk.pte_hits, walk.pte_misses, walk.cycles, walk.walks ? (double)walk.cycles / walk.walks : 0.0);
+    printf("TLB reach: L1 %lld KiB, L2 %lld KiB\n", (long long)vm_settings.l1_entries * vm_settings.page_size >> 10,
+           (long long)vm_settings.l2_entries * vm_settings.page_size >> 10);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <stdio.h>
+
+#ifndef VM_H
+#define VM_H
+
+#include "simulator.h"
+
+#define PAGE_SHIFT 12
+#define PTE_SIZE 8
+#define PTES_PER_TABLE 512
+#define PAGE_TABLE_BASE STACK_START             // Physical address of the root table, just above data memory
+#define PAGE_TABLE_PAGES 3                      // Root, one middle and one leaf table cover all of memory
+#define PAGE_TABLE_SIZE (PAGE_TABLE_PAGES << PAGE_SHIFT)
+
+// Sv39 PTE bits
+#define PTE_V 0x01
+#define PTE_R 0x02
+#define PTE_W 0x04
+#define PTE_X 0x08
+#define PTE_A 0x40
+#define PTE_D 0x80
+
+typedef enum{
+    VM_FETCH,
+    VM_LOAD,
+    VM_STORE
+} vm_access;
+
+typedef struct{
+    int l1_entries;         // Per L1 TLB, the instruction and data side have one each
+    int l1_ways;
+    int l2_entries;         // Shared second level TLB, 0 leaves it out
+    int l2_ways;
+    int l2_latency;         // Cycles of an L2 lookup after an L1 miss
+    int page_size;          // 4 KiB pages, 2 MiB megapages or 1 GiB gigapages
+    int pte_latency;        // Cycles of one page table read on top of its cache access
+    int memory_latency;     // Extra cycles of a page table read that misses, unless the DRAM model times it
+    int translate_fetch;    // 1 also translates instruction fetches through the ITLB
+} vm_config;
+
+typedef struct{
+    long long accesses;
+    long long l1_hits;
+    long long l2_hits;
+    long long walks;
+    long long faults;           // Unmapped addresses and permission violations, counted and otherwise ignored
+    long long stall_cycles;     // Cycles beyond an L1 hit
+} tlb_stats;
+
+typedef struct{
+    long long walks;
+    long long pte_reads;
+    long long pte_hits;         // Page table reads that hit the data cache
+    long long pte_misses;
+    long long memory_cycles;    // Cycles the page table reads waited on DRAM
+    long long cycles;
+} walk_stats;
+
+// Counters a retired instruction is charged from, taken before it runs
+typedef struct{
+    long long pte_hits, pte_misses, memory_cycles;
+    long long itlb_cycles, dtlb_cycles;
+} vm_marker;
+
+extern int vm_enabled;
+extern vm_config vm_settings;
+extern unsigned char page_table_memory[PAGE_TABLE_SIZE];
+
+void enable_vm(char* config_file);
+void disable_vm();
+void vm_reset();
+void vm_translate(unsigned address, vm_access kind);
+vm_marker vm_mark();
+void vm_account(retired_instr* retired, vm_marker* before);
+void print_vm_stats();
+
+#endif
\ No newline at end of file